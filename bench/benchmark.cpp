@@ -0,0 +1,242 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Timing of the search, interpolation and extrapolation paths of LookupTable1D and LookupTable2D.
+// Every case prints one CSV row, compare the files of two commits to catch regressions.
+namespace
+{
+    enum class InputPattern
+    {
+        sweep = 0,       // sorted ramp over the axis range
+        random = 1,      // uniform random inside the range
+        drift = 2,       // random walk with steps of about half a breakpoint spacing
+        out_of_range = 3 // mostly below or above the axis, exercises extrapolation
+    };
+    const std::vector<InputPattern> input_patterns{InputPattern::sweep, InputPattern::random, InputPattern::drift, InputPattern::out_of_range};
+    const std::vector<std::string> pattern_names{"sweep", "random", "drift", "out_of_range"};
+    const std::vector<std::string> search_names{"seq", "bin", "near", "adaptive", "batch", "bin_coeffs", "sorted"};
+
+    const std::size_t input_count = 1U << 16;    // inputs are generated once per case and reused cyclically
+    const std::size_t chunk_size = 256U;         // lookups between two clock reads
+    const double time_budget = 0.02;             // seconds per case
+    volatile double sink = 0;                    // keeps the compiler from dropping the lookups
+
+    // Evenly spaced axes take the direct index path, graded axes (denser at the start) are really searched
+    Eigen::RowVectorXd MakeAxis(const std::size_t &size, const bool &uniform)
+    {
+        Eigen::RowVectorXd axis = Eigen::RowVectorXd::LinSpaced(size, 0.0, static_cast<double>(size - 1));
+        return uniform ? axis : Eigen::RowVectorXd(axis.array() + axis.array().square() / static_cast<double>(size));
+    }
+
+    std::vector<double> MakeInputs(const InputPattern &pattern, const double &lower, const double &upper, const std::size_t &size, const unsigned &seed)
+    {
+        std::mt19937_64 generator(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        const double span = upper - lower;
+        std::vector<double> inputs(input_count);
+        double position = lower + 0.5 * span;
+        for (std::size_t i = 0; i != input_count; ++i)
+        {
+            switch (pattern)
+            {
+            case InputPattern::sweep:
+                inputs[i] = lower + span * static_cast<double>(i) / static_cast<double>(input_count - 1);
+                break;
+            case InputPattern::random:
+                inputs[i] = lower + span * unit(generator);
+                break;
+            case InputPattern::drift:
+                position += (unit(generator) - 0.5) * span / static_cast<double>(size);
+                position = std::min(std::max(position, lower), upper);
+                inputs[i] = position;
+                break;
+            case InputPattern::out_of_range:
+            {
+                double draw = unit(generator);
+                inputs[i] = draw < 0.35 ? lower - span * unit(generator) : draw < 0.7 ? upper + span * unit(generator) : lower + span * unit(generator);
+                break;
+            }
+            }
+        }
+        return inputs;
+    }
+
+    struct Timing
+    {
+        std::size_t lookups = 0;
+        double ns_per_lookup = 0;
+    };
+
+    // Run chunks of lookups until the time budget is used, lookup(i) does one lookup on input i
+    template <typename LookupFunction>
+    Timing Measure(LookupFunction &&lookup)
+    {
+        typedef std::chrono::steady_clock Clock;
+        Timing timing;
+        double elapsed = 0;
+        const Clock::time_point start = Clock::now();
+        std::size_t next = 0;
+        while (elapsed < time_budget)
+        {
+            double sum = 0;
+            for (std::size_t i = 0; i != chunk_size; ++i, ++next)
+            {
+                sum += lookup(next % input_count);
+            }
+            sink = sink + sum;
+            timing.lookups += chunk_size;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        timing.ns_per_lookup = 1e9 * elapsed / static_cast<double>(timing.lookups);
+        return timing;
+    }
+
+    void WriteRow(std::ostream &output, const std::string &table, const bool &uniform, const std::size_t &rows, const std::size_t &cols,
+                  const std::size_t &pattern, const std::size_t &search, const Timing &timing)
+    {
+        output << table << ',' << (uniform ? "uniform" : "graded") << ',' << rows << ',' << cols << ',' << pattern_names[pattern] << ','
+               << search_names[search] << ',' << timing.lookups << ',' << timing.ns_per_lookup << ',' << 1e3 / timing.ns_per_lookup << std::endl;
+    }
+
+    void Benchmark1D(std::ostream &output)
+    {
+        const std::vector<std::size_t> sizes{8, 64, 512, 4096, 32768, 262144, 1000000};
+        for (const auto &size : sizes)
+        {
+            for (const bool uniform : {false, true})
+            {
+                Eigen::RowVectorXd x_axis = MakeAxis(size, uniform);
+                LookupTable1D table(x_axis, x_axis.array().sqrt().matrix());
+                for (std::size_t pattern = 0; pattern != input_patterns.size(); ++pattern)
+                {
+                    std::vector<double> inputs = MakeInputs(input_patterns[pattern], x_axis(0), x_axis(size - 1), size, 1U);
+                    // seq and bin are set before every lookup, otherwise Lookup switches to near after the first call
+                    for (std::size_t search = 0; search != 4; ++search)
+                    {
+                        LookupTable::SearchMethod method = static_cast<LookupTable::SearchMethod>(search);
+                        table.SetSearchMethod(method);
+                        Timing timing = Measure([&](const std::size_t &i)
+                                                {
+                            table.SetSearchMethod(method);
+                            return table.Lookup(inputs[i]); });
+                        WriteRow(output, "1d", uniform, size, 0, pattern, search, timing);
+                    }
+                    // Batch lookup of one chunk at a time with near search, counted per sample
+                    std::vector<double> results(chunk_size);
+                    table.SetSearchMethod(LookupTable::SearchMethod::near);
+                    Timing timing = Measure([&](const std::size_t &i)
+                                            {
+                        if (i % chunk_size != 0)
+                        {
+                            return 0.0;
+                        }
+                        table.Lookup(&inputs[i], results.data(), std::min(chunk_size, input_count - i));
+                        return results[0]; });
+                    WriteRow(output, "1d", uniform, size, 0, pattern, 4, timing);
+                    // Binary search with precomputed segment coefficients, compare with the bin row
+                    table.SetSegmentCoefficients(true);
+                    timing = Measure([&](const std::size_t &i)
+                                     {
+                        table.SetSearchMethod(LookupTable::SearchMethod::bin);
+                        return table.Lookup(inputs[i]); });
+                    table.SetSegmentCoefficients(false);
+                    WriteRow(output, "1d", uniform, size, 0, pattern, 5, timing);
+                    // Merge lookup of one chunk at a time, meant for the sweep pattern
+                    LookupTable::LookupCursor cursor;
+                    timing = Measure([&](const std::size_t &i)
+                                     {
+                        if (i % chunk_size != 0)
+                        {
+                            return 0.0;
+                        }
+                        table.LookupSorted(&inputs[i], results.data(), std::min(chunk_size, input_count - i), cursor);
+                        return results[0]; });
+                    WriteRow(output, "1d", uniform, size, 0, pattern, 6, timing);
+                }
+            }
+        }
+    }
+
+    void Benchmark2D(std::ostream &output)
+    {
+        const std::vector<std::size_t> sizes{8, 32, 128, 512, 1000};
+        for (const auto &size : sizes)
+        {
+            for (const bool uniform : {false, true})
+            {
+                Eigen::RowVectorXd axis = MakeAxis(size, uniform);
+                LookupTable2D table(axis, axis, axis.transpose() * axis);
+                for (std::size_t pattern = 0; pattern != input_patterns.size(); ++pattern)
+                {
+                    std::vector<double> rinputs = MakeInputs(input_patterns[pattern], axis(0), axis(size - 1), size, 1U);
+                    std::vector<double> cinputs = MakeInputs(input_patterns[pattern], axis(0), axis(size - 1), size, 2U);
+                    for (std::size_t search = 0; search != 4; ++search)
+                    {
+                        LookupTable::SearchMethod method = static_cast<LookupTable::SearchMethod>(search);
+                        table.SetSearchMethod(method);
+                        Timing timing = Measure([&](const std::size_t &i)
+                                                {
+                            table.SetSearchMethod(method);
+                            return table.Lookup(rinputs[i], cinputs[i]); });
+                        WriteRow(output, "2d", uniform, size, size, pattern, search, timing);
+                    }
+                    std::vector<double> results(chunk_size);
+                    table.SetSearchMethod(LookupTable::SearchMethod::near);
+                    Timing timing = Measure([&](const std::size_t &i)
+                                            {
+                        if (i % chunk_size != 0)
+                        {
+                            return 0.0;
+                        }
+                        table.Lookup(&rinputs[i], &cinputs[i], results.data(), std::min(chunk_size, input_count - i));
+                        return results[0]; });
+                    WriteRow(output, "2d", uniform, size, size, pattern, 4, timing);
+                    table.SetSegmentCoefficients(true);
+                    timing = Measure([&](const std::size_t &i)
+                                     {
+                        table.SetSearchMethod(LookupTable::SearchMethod::bin);
+                        return table.Lookup(rinputs[i], cinputs[i]); });
+                    table.SetSegmentCoefficients(false);
+                    WriteRow(output, "2d", uniform, size, size, pattern, 5, timing);
+                    LookupTable::LookupCursor cursor;
+                    timing = Measure([&](const std::size_t &i)
+                                     {
+                        if (i % chunk_size != 0)
+                        {
+                            return 0.0;
+                        }
+                        table.LookupSorted(&rinputs[i], &cinputs[i], results.data(), std::min(chunk_size, input_count - i), cursor);
+                        return results[0]; });
+                    WriteRow(output, "2d", uniform, size, size, pattern, 6, timing);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::ofstream file;
+    if (argc > 1)
+    {
+        file.open(argv[1]);
+        if (!file)
+        {
+            std::cerr << "cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = argc > 1 ? file : std::cout;
+    output << "table,axis,rows,cols,pattern,search,lookups,ns_per_lookup,mlookups_per_s" << std::endl;
+    Benchmark1D(output);
+    Benchmark2D(output);
+    return 0;
+}
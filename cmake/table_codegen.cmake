@@ -0,0 +1,20 @@
+# Generates a header of constexpr FixedLookupTable definitions from calibration data at build time.
+#   add_calibration_header(<target> OUTPUT <header> [NAMESPACE <name>] INPUTS <file.csv | calibration file>...)
+# The header is regenerated when an input changes and an invalid table fails the build. The generator runs on the
+# build host, so it is built from this project with the host compiler.
+function(add_calibration_header TARGET_NAME)
+  cmake_parse_arguments(CODEGEN "" "OUTPUT;NAMESPACE" "INPUTS" ${ARGN})
+  if(NOT CODEGEN_NAMESPACE)
+    set(CODEGEN_NAMESPACE calibration)
+  endif()
+  get_filename_component(CODEGEN_DIR ${CODEGEN_OUTPUT} DIRECTORY)
+  add_custom_command(
+    OUTPUT ${CODEGEN_OUTPUT}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CODEGEN_DIR}
+    COMMAND table_codegen --output ${CODEGEN_OUTPUT} --namespace ${CODEGEN_NAMESPACE} ${CODEGEN_INPUTS}
+    DEPENDS table_codegen ${CODEGEN_INPUTS}
+    COMMENT "Generating constexpr tables ${CODEGEN_OUTPUT}"
+    VERBATIM)
+  target_sources(${TARGET_NAME} PRIVATE ${CODEGEN_OUTPUT})
+  target_include_directories(${TARGET_NAME} PRIVATE ${CODEGEN_DIR})
+endfunction()
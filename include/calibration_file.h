@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+#include "lookup_table_view.h"
+
+// Binary container for many named 1D/2D tables. Layout, native byte order:
+//   header (64 bytes)      magic, version, byte order mark, table count, directory offset, file size, checksum
+//   directory              one fixed-size entry per table sorted by name: sizes, methods, accelerators, data offsets
+//   data                   axes and values as double arrays, every array starts on a 64-byte boundary
+// 2D maps are stored row by row. Tables are validated when they are added to the writer, so the loader only checks
+// the header and the checksum, and views are created on demand with a binary search of the directory.
+class CalibrationFile
+{
+public:
+    enum class FileState
+    {
+        empty = 0,                // no file opened
+        open_failed = -1,         // file cannot be opened or mapped
+        format_invalid = -2,      // bad magic, byte order, or sizes out of the file
+        version_not_match = -3,   // written by another format version
+        checksum_not_match = -4,  // data corrupted
+        valid = 1                 // valid state
+    };
+
+    static constexpr std::uint32_t version_ = 1U;
+    static constexpr std::size_t alignment_ = 64U;
+    static constexpr std::size_t max_name_size_ = 63U; // names are stored with a terminating zero
+
+    // Constructors and destructor, the mapping is released with the object so views must not outlive it
+    CalibrationFile() = default;
+    explicit CalibrationFile(const std::string &path, const bool &verify_checksum = true) { file_state_ = Open(path, verify_checksum); }
+    CalibrationFile(const CalibrationFile &) = delete;
+    CalibrationFile &operator=(const CalibrationFile &) = delete;
+    ~CalibrationFile() { Close(); }
+
+    // Get file state
+    bool valid() const { return file_state_ == FileState::valid; }
+    FileState state() const { return file_state_; }
+    std::size_t size() const { return table_count_; }
+
+    // Map the file and check the header, the checksum pass reads the data once
+    FileState Open(const std::string &path, const bool &verify_checksum = true);
+    void Close();
+
+    // Find a table by name, an invalid view is returned if the name is missing or has another dimension
+    bool Contains(const std::string &name) const;
+    std::vector<std::string> Names() const; // every table name in directory order
+    LookupTable1DView Table1D(const std::string &name) const;
+    LookupTable2DView Table2D(const std::string &name) const;
+
+private:
+    struct DirectoryEntry;
+
+    FileState file_state_ = FileState::empty;
+    const unsigned char *file_data_ = nullptr;
+    std::size_t file_size_ = 0U;
+    std::size_t table_count_ = 0U;
+    const DirectoryEntry *directory_ = nullptr;
+    std::vector<std::uint64_t> file_buffer_; // used when the file cannot be memory-mapped
+
+    const DirectoryEntry *Find(const std::string &name) const;
+    const double *Array(const std::uint64_t &offset, const std::uint64_t &count) const;
+
+    friend class CalibrationFileWriter;
+};
+
+class CalibrationFileWriter
+{
+public:
+    // Add a copy of a valid table, fails for invalid tables, tables using a spline method, empty or too long names,
+    // and names already added
+    bool AddTable(const std::string &name, const LookupTable1D &table);
+    bool AddTable(const std::string &name, const LookupTable2D &table);
+    std::size_t size() const { return tables_.size(); }
+
+    // Write all tables to one file
+    bool Write(const std::string &path) const;
+
+private:
+    struct TableRecord
+    {
+        std::string name;
+        std::size_t rows = 0U; // breakpoints of the first axis
+        std::size_t cols = 0U; // breakpoints of the second axis, 0 for 1D tables
+        std::vector<double> row_axis;
+        std::vector<double> col_axis;
+        std::vector<double> data;
+        LookupTable::InterpMethod interp_method = LookupTable::InterpMethod::linear;
+        LookupTable::ExtrapMethod extrap_method = LookupTable::ExtrapMethod::clip;
+        double lower_value = 0;
+        double upper_value = 0;
+        LookupTable::AxisAccelerator row_accelerator;
+        LookupTable::AxisAccelerator col_accelerator;
+    };
+    std::vector<TableRecord> tables_;
+
+    bool AcceptName(const std::string &name) const;
+};
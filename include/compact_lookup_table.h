@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Tables with reduced-precision storage of the table values, built from a validated double table. Floating point
+// storage keeps the values as they are, integer storage is fixed point with a per-table scale and offset:
+// value = offset + scale * stored. Axes stay in double so the search matches the reference table, and interpolation
+// runs in double on the dequantized values. Spline methods act as linear on compact tables.
+class CompactLookupTable : public LookupTable
+{
+public:
+    // Accuracy of a compact table against its double reference, at every breakpoint and segment midpoint. A spline
+    // reference is compared as linear, so the report holds the quantization error only.
+    struct QuantizationReport
+    {
+        double max_abs_error = 0;          // largest absolute error
+        double max_rel_error = 0;          // largest error relative to the reference value
+        double rms_error = 0;              // root mean square error
+        std::size_t samples = 0;           // number of compared points
+        std::size_t reference_bytes = 0;   // memory of the reference table values and axes
+        std::size_t compact_bytes = 0;     // memory of the compact table values and axes
+    };
+
+    // Get quantization parameters
+    double scale() const { return scale_; }
+    double offset() const { return offset_; }
+
+protected:
+    double scale_ = 1;  // value = offset + scale * stored
+    double offset_ = 0;
+
+    // Choose scale and offset for the storage type, then convert the values
+    template <typename Storage>
+    void Quantize(const double *values, const std::size_t &count, Storage *stored);
+
+    // Add one compared point to the report, Finish turns the sums into the final figures
+    void AccumulateError(QuantizationReport &report, const double &reference, const double &value, double &square_sum) const;
+    void FinishReport(QuantizationReport &report, const double &square_sum) const;
+};
+
+template <typename Storage>
+class CompactLookupTable1D : public CompactLookupTable
+{
+public:
+    // Constructors and destructor
+    CompactLookupTable1D() = default;
+    explicit CompactLookupTable1D(const LookupTable1D &reference) { table_assigned_ = AssignTableData(reference); }
+    ~CompactLookupTable1D() = default;
+
+    // Get table state
+    std::size_t size() const { return table_size_; }
+    std::size_t memory_bytes() const { return table_size_ * (sizeof(double) + sizeof(Storage)); }
+
+    // Quantize a valid reference table, its methods and specified extrapolation values are copied as well
+    AssignmentState AssignTableData(const LookupTable1D &reference);
+    bool ClearTable() override;
+
+    // Lookup table based on input, using current search, interp, and extrap methods
+    double Lookup(const double &xvalue);
+    double Lookup(const double &xvalue, LookupCursor &cursor) const;
+
+    // Compare against the double reference table
+    QuantizationReport AccuracyReport(const LookupTable1D &reference) const;
+
+private:
+    // Core members
+    Eigen::RowVectorXd x_axis_;
+    Eigen::Matrix<Storage, 1, Eigen::Dynamic> y_table_;
+    double lookup_result_ = 0;      // restore output value.
+    std::size_t prelook_index_ = 0; // restore prelook index value.
+    // Other parameters
+    std::size_t table_size_ = 0U;
+    double lower_extrap_value_specify_ = 0;
+    double upper_extrap_value_specify_ = 0;
+    AxisAccelerator x_accelerator_;
+
+    // Dequantized table value
+    double Value(const std::size_t &index) const { return offset_ + scale_ * static_cast<double>(y_table_(index)); }
+
+    // Interpolation or extrapolation for a searched index, fallback is returned for unknown methods
+    double Evaluate(const std::size_t &index, const double &xvalue, const double &fallback) const;
+};
+
+template <typename Storage>
+class CompactLookupTable2D : public CompactLookupTable
+{
+public:
+    // Constructors and destructor
+    CompactLookupTable2D() = default;
+    explicit CompactLookupTable2D(const LookupTable2D &reference) { table_assigned_ = AssignTableData(reference); }
+    ~CompactLookupTable2D() = default;
+
+    // Get table state
+    MatrixIndex size() const { return table_size_; }
+    std::size_t memory_bytes() const { return (table_size_.rows() + table_size_.cols()) * sizeof(double) + table_size_.rows() * table_size_.cols() * sizeof(Storage); }
+
+    // Quantize a valid reference table, its methods are copied as well
+    AssignmentState AssignTableData(const LookupTable2D &reference);
+    bool ClearTable() override;
+
+    // Lookup table based on input, linear interpolation and clip extrapolation like LookupTable2D
+    double Lookup(const double &rvalue, const double &cvalue);
+    double Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const;
+
+    // Compare against the double reference table
+    QuantizationReport AccuracyReport(const LookupTable2D &reference) const;
+
+private:
+    // Core members
+    Eigen::RowVectorXd row_axis_;
+    Eigen::RowVectorXd col_axis_;
+    Eigen::Matrix<Storage, Eigen::Dynamic, Eigen::Dynamic> map_matrix_;
+    double lookup_result_ = 0;
+    MatrixIndex prelook_index_{0, 0};
+    // Table state members
+    MatrixIndex table_size_{0, 0};
+    AxisAccelerator row_accelerator_;
+    AxisAccelerator col_accelerator_;
+
+    // Dequantized map value
+    double Value(const std::size_t &row, const std::size_t &col) const { return offset_ + scale_ * static_cast<double>(map_matrix_(row, col)); }
+
+    // Interpolation or clip extrapolation for a searched cell
+    double Evaluate(const std::size_t &rindex, const std::size_t &cindex, const double &rvalue, const double &cvalue) const;
+};
+
+// Common storage choices: single precision, Q15 and Q31 fixed point
+typedef CompactLookupTable1D<float> LookupTable1DFloat;
+typedef CompactLookupTable1D<std::int16_t> LookupTable1DQ15;
+typedef CompactLookupTable1D<std::int32_t> LookupTable1DQ31;
+typedef CompactLookupTable2D<float> LookupTable2DFloat;
+typedef CompactLookupTable2D<std::int16_t> LookupTable2DQ15;
+typedef CompactLookupTable2D<std::int32_t> LookupTable2DQ31;
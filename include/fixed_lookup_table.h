@@ -0,0 +1,214 @@
+#pragma once
+#include <array>
+#include <limits>
+#include <cstddef>
+#include "lookup_table.h"
+
+// Fixed-size tables for loops where the table sizes are known at build time. The data lives in std::array members,
+// the methods are template parameters, and there is no heap and no virtual dispatch. Construction, validation and
+// lookup are constexpr, the search follows SearchMethod::bin of LookupTable.
+class FixedLookupTable
+{
+public:
+    typedef LookupTable::InterpMethod InterpMethod;
+    typedef LookupTable::ExtrapMethod ExtrapMethod;
+    typedef LookupTable::TableState TableState;
+
+    static constexpr std::size_t max_table_size_ = 1000000U; // same limit as LookupTable
+
+protected:
+    static constexpr double epsilon_ = std::numeric_limits<double>::epsilon();
+
+    // constexpr replacement of std::abs
+    static constexpr double Abs(const double &value) { return value < 0 ? -value : value; }
+
+    template <std::size_t N>
+    static constexpr bool isStrictlyIncreasing(const std::array<double, N> &input_array)
+    {
+        for (std::size_t index = 1; index < N; ++index)
+        {
+            if (!(input_array[index] - input_array[index - 1] >= epsilon_)) // also rejects NaN
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Same result as LookupTable::SearchBinary
+    template <std::size_t N>
+    static constexpr std::size_t SearchBinary(const double &value, const std::array<double, N> &table)
+    {
+        if (value <= table[0])
+        {
+            return 0;
+        }
+        else if (value >= table[N - 1])
+        {
+            return N;
+        }
+        std::size_t left = 0;
+        std::size_t right = N - 1;
+        while (left < right)
+        {
+            std::size_t mid = left + (right - left) / 2;
+            if (value <= table[mid])
+            {
+                right = mid;
+            }
+            else
+            {
+                left = mid + 1;
+            }
+        }
+        return left;
+    }
+
+    // Interpolation basic form, same operations as LookupTable::Interpolate
+    static constexpr double Interpolate(const double &xvalue, const double &x1, const double &x2, const double &y1, const double &y2)
+    {
+        return y1 + (Abs(x2 - x1) < epsilon_ ? 0.5 : (xvalue - x1) / (x2 - x1)) * (y2 - y1);
+    }
+    static constexpr double Interpolate(const double &rvalue, const double &cvalue,
+                                        const double &r1, const double &r2,
+                                        const double &c1, const double &c2,
+                                        const double &m11, const double &m12,
+                                        const double &m21, const double &m22)
+    {
+        const double rweight = Abs(r2 - r1) < epsilon_ ? 0.5 : (rvalue - r1) / (r2 - r1);
+        const double cweight = Abs(c2 - c1) < epsilon_ ? 0.5 : (cvalue - c1) / (c2 - c1);
+        return (1 - rweight) * ((1 - cweight) * m11 + cweight * m12) + rweight * ((1 - cweight) * m21 + cweight * m22);
+    }
+};
+
+template <std::size_t N,
+          LookupTable::InterpMethod Interp = LookupTable::InterpMethod::linear,
+          LookupTable::ExtrapMethod Extrap = LookupTable::ExtrapMethod::clip>
+class FixedLookupTable1D : public FixedLookupTable
+{
+    static_assert(N >= 2 && N <= max_table_size_, "table size must be within the range [2 1M]");
+    static_assert(Interp == InterpMethod::nearest || Interp == InterpMethod::linear || Interp == InterpMethod::next || Interp == InterpMethod::previous,
+                  "unsupported interpolation method for fixed tables");
+
+public:
+    // Constructors, the specified extrapolation values default to the end values like LookupTable1D::SetExtrapMethod
+    constexpr FixedLookupTable1D(const std::array<double, N> &x_axis, const std::array<double, N> &y_table)
+        : FixedLookupTable1D(x_axis, y_table, y_table[0], y_table[N - 1]) {}
+    constexpr FixedLookupTable1D(const std::array<double, N> &x_axis, const std::array<double, N> &y_table, const double &lower_value, const double &upper_value)
+        : x_axis_{x_axis}, y_table_{y_table}, lower_extrap_value_specify_{lower_value}, upper_extrap_value_specify_{upper_value}, table_state_{CheckTableState(x_axis)} {}
+
+    // Get table state
+    constexpr bool valid() const { return table_state_ == TableState::valid; }
+    constexpr TableState state() const { return table_state_; }
+    static constexpr std::size_t size() { return N; }
+    constexpr const std::array<double, N> &x_axis() const { return x_axis_; }
+    constexpr const std::array<double, N> &y_table() const { return y_table_; }
+
+    // Lookup table based on input, an invalid table always returns 0
+    constexpr double Lookup(const double &xvalue) const
+    {
+        if (!valid())
+        {
+            return 0;
+        }
+        const std::size_t index = SearchBinary(xvalue, x_axis_);
+        return (index == 0 || index == N) ? Extrapolation(index, xvalue) : Interpolation(index, xvalue);
+    }
+
+private:
+    std::array<double, N> x_axis_;
+    std::array<double, N> y_table_;
+    double lower_extrap_value_specify_;
+    double upper_extrap_value_specify_;
+    TableState table_state_;
+
+    static constexpr TableState CheckTableState(const std::array<double, N> &x_axis)
+    {
+        return isStrictlyIncreasing(x_axis) ? TableState::valid : TableState::axis_not_increase;
+    }
+
+    // The method branches are resolved at compile time
+    constexpr double Interpolation(const std::size_t &index, const double &xvalue) const
+    {
+        return Interp == InterpMethod::linear    ? Interpolate(xvalue, x_axis_[index - 1], x_axis_[index], y_table_[index - 1], y_table_[index])
+               : Interp == InterpMethod::nearest ? (((xvalue - x_axis_[index - 1]) <= (x_axis_[index] - xvalue)) ? y_table_[index - 1] : y_table_[index])
+               : Interp == InterpMethod::next    ? y_table_[index]
+                                                 : y_table_[index - 1];
+    }
+    constexpr double Extrapolation(const std::size_t &index, const double &xvalue) const
+    {
+        return Extrap == ExtrapMethod::linear
+                   ? (index == 0 ? Interpolate(xvalue, x_axis_[0], x_axis_[1], y_table_[0], y_table_[1])
+                                 : Interpolate(xvalue, x_axis_[N - 2], x_axis_[N - 1], y_table_[N - 2], y_table_[N - 1]))
+               : Extrap == ExtrapMethod::specify ? (index == 0 ? lower_extrap_value_specify_ : upper_extrap_value_specify_)
+                                                 : (index == 0 ? y_table_[0] : y_table_[N - 1]);
+    }
+};
+
+// The map is stored row by row, the same order as the std::vector constructor of LookupTable2D.
+// Like LookupTable2D, only linear interpolation and clip extrapolation are available.
+template <std::size_t R, std::size_t C,
+          LookupTable::InterpMethod Interp = LookupTable::InterpMethod::linear,
+          LookupTable::ExtrapMethod Extrap = LookupTable::ExtrapMethod::clip>
+class FixedLookupTable2D : public FixedLookupTable
+{
+    static_assert(R >= 2 && R <= max_table_size_ && C >= 2 && C <= max_table_size_, "table size must be within the range [2 1M]");
+    static_assert(Interp == InterpMethod::linear && Extrap == ExtrapMethod::clip, "2D tables only support linear interpolation and clip extrapolation");
+
+public:
+    constexpr FixedLookupTable2D(const std::array<double, R> &row_axis, const std::array<double, C> &col_axis, const std::array<double, R * C> &map_array)
+        : row_axis_{row_axis}, col_axis_{col_axis}, map_array_{map_array}, table_state_{CheckTableState(row_axis, col_axis)} {}
+
+    // Get table state
+    constexpr bool valid() const { return table_state_ == TableState::valid; }
+    constexpr TableState state() const { return table_state_; }
+    static constexpr std::size_t rows() { return R; }
+    static constexpr std::size_t cols() { return C; }
+    constexpr const std::array<double, R> &row_axis() const { return row_axis_; }
+    constexpr const std::array<double, C> &col_axis() const { return col_axis_; }
+    constexpr double map(const std::size_t &row, const std::size_t &col) const { return map_array_[row * C + col]; }
+
+    // Lookup table based on input, an invalid table always returns 0
+    constexpr double Lookup(const double &rvalue, const double &cvalue) const
+    {
+        if (!valid())
+        {
+            return 0;
+        }
+        const std::size_t rindex = SearchBinary(rvalue, row_axis_);
+        const std::size_t cindex = SearchBinary(cvalue, col_axis_);
+        if (rindex > 0 && rindex < R && cindex > 0 && cindex < C)
+        {
+            return Interpolate(rvalue, cvalue, row_axis_[rindex - 1], row_axis_[rindex], col_axis_[cindex - 1], col_axis_[cindex],
+                               map(rindex - 1, cindex - 1), map(rindex - 1, cindex), map(rindex, cindex - 1), map(rindex, cindex));
+        }
+        return Extrapolation(rindex, cindex, rvalue, cvalue);
+    }
+
+private:
+    std::array<double, R> row_axis_;
+    std::array<double, C> col_axis_;
+    std::array<double, R * C> map_array_;
+    TableState table_state_;
+
+    static constexpr TableState CheckTableState(const std::array<double, R> &row_axis, const std::array<double, C> &col_axis)
+    {
+        return (isStrictlyIncreasing(row_axis) && isStrictlyIncreasing(col_axis)) ? TableState::valid : TableState::axis_not_increase;
+    }
+
+    // Clip on the axes that are out of range, interpolate along the other one
+    constexpr double Extrapolation(const std::size_t &rindex, const std::size_t &cindex, const double &rvalue, const double &cvalue) const
+    {
+        if (rindex < 1 || rindex >= R)
+        {
+            const std::size_t row = rindex < 1 ? 0 : R - 1;
+            if (cindex < 1 || cindex >= C)
+            {
+                return map(row, cindex < 1 ? 0 : C - 1);
+            }
+            return Interpolate(cvalue, col_axis_[cindex - 1], col_axis_[cindex], map(row, cindex - 1), map(row, cindex));
+        }
+        const std::size_t col = cindex < 1 ? 0 : C - 1;
+        return Interpolate(rvalue, row_axis_[rindex - 1], row_axis_[rindex], map(rindex - 1, col), map(rindex, col));
+    }
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Copy of the lookup statistics of one table. Search counters count axis searches: one per 1D lookup, two per 2D
+// lookup (one per axis), and inverse lookups search their own axis.
+struct LookupStatisticsSnapshot
+{
+    static constexpr std::size_t histogram_size_ = 24U; // bucket b counts sampled lookups of [2^b, 2^(b+1)) ns
+
+    bool enabled = false;                          // false when the library is built without LOOKUP_TABLE_STATISTICS
+    std::uint64_t lookups = 0;                     // lookup inputs, scalar, batch, sorted and gradient
+    std::uint64_t scalar_lookups = 0;              // scalar and cursor lookups, the ones the timer samples
+    std::uint64_t searches = 0;                    // axis searches
+    std::uint64_t interpolations = 0;              // searches that end inside the axis
+    std::uint64_t below = 0;                       // searches below the first breakpoint
+    std::uint64_t above = 0;                       // searches above the last breakpoint
+    std::array<std::uint64_t, 3> extrapolations{}; // searches outside the axis by extrap method: clip, linear, specify
+    std::uint64_t walks = 0;                       // near, adaptive and merge searches, which start from the last index
+    std::uint64_t walk_distance = 0;               // breakpoints moved by those searches
+    std::uint64_t fallbacks = 0;                   // adaptive searches that fell back to the binary search
+    std::uint64_t samples = 0;                     // timed lookups
+    std::uint64_t sampled_ns = 0;                  // total time of the timed lookups
+    std::array<std::uint64_t, histogram_size_> latency_histogram{};
+
+    double mean_walk() const { return walks > 0 ? static_cast<double>(walk_distance) / static_cast<double>(walks) : 0; }
+    double mean_latency_ns() const { return samples > 0 ? static_cast<double>(sampled_ns) / static_cast<double>(samples) : 0; }
+    double estimated_ns() const { return mean_latency_ns() * static_cast<double>(scalar_lookups); } // time spent in scalar lookups
+
+    // One CSV row per table, the header names the columns
+    static void WriteCsvHeader(std::ostream &output);
+    void WriteCsv(std::ostream &output, const std::string &name) const;
+};
+
+// Counters of one table, compiled in when LOOKUP_TABLE_STATISTICS is defined (cmake -DLOOKUP_TABLE_STATISTICS=ON).
+// The counters are relaxed atomics updated with a plain load and store instead of a locked read-modify-write, so a
+// lookup pays a few additions. Concurrent cursor lookups on one table may lose increments, counts never tear.
+// One scalar lookup in sample_period_ is timed into the latency histogram.
+class LookupStatistics
+{
+public:
+    static constexpr std::uint64_t sample_period_ = 64U;
+
+    // Times a sampled lookup from construction to destruction, does nothing for the other lookups
+    class Timer
+    {
+    public:
+        explicit Timer(LookupStatistics *statistics) : statistics_{statistics}
+        {
+            if (statistics_ != nullptr)
+            {
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+        Timer(Timer &&other) : statistics_{other.statistics_}, start_{other.start_} { other.statistics_ = nullptr; }
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+        ~Timer()
+        {
+            if (statistics_ != nullptr)
+            {
+                statistics_->RecordLatency(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+            }
+        }
+
+    private:
+        LookupStatistics *statistics_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Constructors, a copied table starts with the counts of its source
+    LookupStatistics() = default;
+    LookupStatistics(const LookupStatistics &other) { CopyFrom(other); }
+    LookupStatistics &operator=(const LookupStatistics &other)
+    {
+        CopyFrom(other);
+        return *this;
+    }
+
+    // Count lookup inputs, the returned timer times every sample_period_-th scalar lookup
+    Timer StartLookup()
+    {
+        lookups_.Add(1);
+        const std::uint64_t scalar_lookups = scalar_lookups_.Add(1);
+        return Timer(scalar_lookups % sample_period_ == 0 ? this : nullptr);
+    }
+    void RecordLookups(const std::size_t &count) { lookups_.Add(count); }
+
+    // Count an axis search that moved from last_index to index on an axis of size breakpoints
+    void RecordSearch(const std::size_t &index, const std::size_t &last_index, const std::size_t &size, const bool &walked, const int &extrap_method)
+    {
+        searches_.Add(1);
+        if (index == 0 || index == size)
+        {
+            (index == 0 ? below_ : above_).Add(1);
+            extrapolations_[static_cast<std::size_t>(extrap_method) < extrapolations_.size() ? extrap_method : 0].Add(1);
+        }
+        else
+        {
+            interpolations_.Add(1);
+        }
+        if (walked)
+        {
+            walks_.Add(1);
+            walk_distance_.Add(index > last_index ? index - last_index : last_index - index);
+        }
+    }
+    void RecordFallback() { fallbacks_.Add(1); }
+    void RecordLatency(const std::int64_t &ns);
+
+    LookupStatisticsSnapshot Snapshot() const;
+    void Reset() { *this = LookupStatistics(); }
+
+private:
+    struct Counter
+    {
+        std::atomic<std::uint64_t> value{0};
+        // Returns the count before the addition
+        std::uint64_t Add(const std::uint64_t &count)
+        {
+            const std::uint64_t previous = value.load(std::memory_order_relaxed);
+            value.store(previous + count, std::memory_order_relaxed);
+            return previous;
+        }
+        std::uint64_t Load() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    Counter lookups_;
+    Counter scalar_lookups_;
+    Counter searches_;
+    Counter interpolations_;
+    Counter below_;
+    Counter above_;
+    std::array<Counter, 3> extrapolations_;
+    Counter walks_;
+    Counter walk_distance_;
+    Counter fallbacks_;
+    Counter samples_;
+    Counter sampled_ns_;
+    std::array<Counter, LookupStatisticsSnapshot::histogram_size_> latency_histogram_;
+
+    void CopyFrom(const LookupStatistics &other);
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Block-wise evaluation of an arbitrarily long signal through one table. Every block continues the merge position of
+// the previous one, so a sorted or slowly varying signal costs O(n + m) in total and only one block is in memory at a
+// time. The table is only read and must outlive the stream, several streams may share one table.
+template <typename Table>
+class LookupStream
+{
+public:
+    static constexpr std::size_t default_block_size_ = 1024U;
+
+    // Constructors and destructor
+    explicit LookupStream(const Table &table, const std::size_t &block_size = default_block_size_) : table_{&table}, block_size_{block_size > 0 ? block_size : default_block_size_} {}
+    ~LookupStream() = default;
+
+    // Get stream state
+    std::size_t block_size() const { return block_size_; }
+    std::size_t processed() const { return processed_; }
+    double last_result() const { return cursor_.result; }
+
+    // Start a new signal, the next block searches from the start of the axes
+    void Reset()
+    {
+        cursor_.Reset();
+        processed_ = 0;
+    }
+
+    // Evaluate the next block of a 1D signal
+    void Process(const double *xvalues, double *results, const std::size_t &count)
+    {
+        table_->LookupSorted(xvalues, results, count, cursor_);
+        processed_ += count;
+    }
+    // Evaluate the next block of a 2D signal
+    void Process(const double *rvalues, const double *cvalues, double *results, const std::size_t &count)
+    {
+        table_->LookupSorted(rvalues, cvalues, results, count, cursor_);
+        processed_ += count;
+    }
+
+    // Pull a 1D signal until it ends: source(buffer, capacity) fills up to capacity inputs and returns how many, 0 at
+    // the end, and sink(results, count) takes every evaluated block. Returns the number of evaluated inputs.
+    template <typename Source, typename Sink>
+    std::size_t Run(Source &&source, Sink &&sink)
+    {
+        std::vector<double> inputs(block_size_);
+        std::vector<double> results(block_size_);
+        std::size_t total = 0;
+        for (std::size_t count = source(inputs.data(), block_size_); count > 0; count = source(inputs.data(), block_size_))
+        {
+            count = count < block_size_ ? count : block_size_;
+            Process(inputs.data(), results.data(), count);
+            sink(static_cast<const double *>(results.data()), count);
+            total += count;
+        }
+        return total;
+    }
+
+private:
+    const Table *table_;
+    std::size_t block_size_;
+    LookupTable::LookupCursor cursor_;
+    std::size_t processed_ = 0;
+};
+
+template <typename Table>
+constexpr std::size_t LookupStream<Table>::default_block_size_;
+
+typedef LookupStream<LookupTable1D> LookupStream1D;
+typedef LookupStream<LookupTable2D> LookupStream2D;
@@ -1,10 +1,13 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <limits>
 #include <cmath>
 #include <algorithm>
 #include <Eigen/Dense>
 #include <unsupported/Eigen/Splines>
+#include "lookup_statistics.h"
 
 class LookupTable
 {
@@ -14,15 +17,19 @@ public:
     {
         seq = 0, // sequential search, from begin to end
         bin = 1, // binary search
-        near = 2 // sequential search based on last value
+        near = 2,    // sequential search based on last value
+        adaptive = 3 // galloping search from the predicted index, binary search while the input keeps jumping
     };
 
     enum class InterpMethod
     {
         nearest = 0, // use nearest point value
         linear = 1,  // linear interpolation
-        next = 2,    // use the next point value
-        previous = 3 // use the previous point value
+        next = 2,     // use the next point value
+        previous = 3, // use the previous point value
+        cubic = 4,    // natural cubic spline
+        pchip = 5,    // shape-preserving piecewise cubic Hermite
+        akima = 6     // Akima spline, less overshoot than cubic near steps
     };
 
     enum class ExtrapMethod
@@ -46,6 +53,12 @@ public:
         axis_not_increase = -3, // x table is not strictly increasing
         valid = 1               // valid state
     };
+    enum class Monotonicity
+    {
+        none = 0,       // not strictly monotone, no inverse lookup
+        increasing = 1, // strictly increasing values
+        decreasing = -1 // strictly decreasing values
+    };
     class MatrixIndex
     {
     public:
@@ -81,6 +94,69 @@ public:
         std::size_t cols_ = 0;
     };
 
+    // Statistics of one axis for SearchMethod::adaptive, a few bytes so they fit in the cursor
+    struct AdaptiveState
+    {
+        std::int32_t last_step = 0; // index change of the last search, the next search starts from last index + last_step
+        float mean_jump = 0;        // moving average of the index change, compared against log2 of the axis size
+    };
+
+    // Per-caller search state for the const lookup functions. The table itself is only read, so one table can be
+    // shared by many threads as long as every thread keeps its own cursor. Aligned to a cache line so cursors kept
+    // side by side in an array do not share a line between threads.
+    struct alignas(64) LookupCursor
+    {
+        std::size_t row_index = 0;    // last index on the row axis, also used as the index of 1D tables
+        std::size_t col_index = 0;    // last index on the column axis
+        bool primed = false;          // false until the first lookup, which uses the configured search method
+        AdaptiveState row_adaptive;   // adaptive search statistics of the row axis
+        AdaptiveState col_adaptive;   // adaptive search statistics of the column axis
+        double result = 0;            // last lookup result, returned while the table is invalid
+        void Reset() { *this = LookupCursor(); }
+    };
+
+    // Search index of a large axis. The axis is cut into blocks of block_size breakpoints and the last breakpoint of
+    // every block is stored in Eytzinger (breadth-first) order: keys()[k] has children keys()[2k] and keys()[2k+1], and
+    // the eight descendants three levels down share one cache line. The tree is an eighth of the axis, so it mostly
+    // stays in cache, and the final block search reads the axis lines that the interpolation needs anyway.
+    struct EytzingerIndex
+    {
+        static constexpr std::size_t block_size = 8U;
+        std::vector<double> storage;          // keys, padded so that keys() starts on a cache line
+        std::vector<std::uint32_t> positions; // block number of every key
+        std::size_t size = 0;                 // number of blocks, keys are stored at 1..size
+        std::size_t offset = 0;               // storage index of keys()[0]
+        const double *keys() const { return storage.data() + offset; }
+    };
+
+    // Auxiliary search data of one axis, rebuilt whenever the table data is validated
+    struct AxisAccelerator
+    {
+        bool uniform = false;    // evenly spaced axis, the index is computed directly instead of searched
+        double origin = 0;       // first breakpoint of the axis
+        double inverse_step = 0; // reciprocal of the breakpoint step
+        std::shared_ptr<const EytzingerIndex> eytzinger; // binary search index of large uneven axes, shared by table copies
+    };
+
+    // Interpolation coefficients packed per 1D segment or 2D cell. The storage is padded so that every group of stride
+    // values starts at a multiple of its own size from a cache line, one lookup then reads a single line.
+    struct SegmentCoefficients
+    {
+        std::vector<double> storage; // coefficients, padded in front for the alignment
+        std::size_t offset = 0;      // storage index of the first group
+        std::size_t stride = 0;      // coefficients per segment or cell, a power of two
+        const double *segment(const std::size_t &index) const { return storage.data() + offset + index * stride; }
+    };
+
+    // Result of a Prelookup on a breakpoint axis, shared by every table on that axis.
+    // index follows SearchIndex: 0 below the axis, size above it, otherwise the value is in (x(index-1), x(index)].
+    // fraction is the position within the nearest segment, below 0 or above 1 when the value is out of range.
+    struct PrelookupResult
+    {
+        std::size_t index = 0;
+        double fraction = 0;
+    };
+
     // Constructors and destructors
     LookupTable() = default;
     virtual ~LookupTable() = default;
@@ -89,22 +165,105 @@ public:
     bool valid() const { return table_valid_; }
     bool empty() const { return table_empty_; }
     TableState state() const { return table_state_; }
+    SearchMethod search_method() const { return search_method_; }
+    InterpMethod interp_method() const { return interp_method_; }
+    ExtrapMethod extrap_method() const { return extrap_method_; }
 
     // Set methods for search, interpolation, and extrapolation
     void SetSearchMethod(const SearchMethod &method) { search_method_ = method; }
-    void SetInterpMethod(const InterpMethod &method) { interp_method_ = method; }
+    virtual void SetInterpMethod(const InterpMethod &method) { interp_method_ = method; }
     virtual void SetExtrapMethod(const ExtrapMethod &method) { extrap_method_ = method; }
     void SetEpsilon(const double &epsilon) { epsilon_ = epsilon > 0 ? epsilon : epsilon_; }
+    // Build the Eytzinger index for uneven axes of at least axis_index_min_size_ breakpoints, on by default.
+    // Tables that override this rebuild their index immediately, the others when their data is next assigned.
+    virtual void SetAxisIndex(const bool &enable) { axis_index_enabled_ = enable; }
+    // Precompute the linear coefficients of every segment (1D) or cell (2D), off by default. A linear lookup is then
+    // a search plus one or two multiply-adds without division, for 2 (1D) or 4 (2D) extra doubles per segment.
+    // Results may differ from the weight formula in the last bits.
+    virtual void SetSegmentCoefficients(const bool &enable) { segment_coeffs_enabled_ = enable; }
 
     // virtual void SetTable() = 0;   // SetTable without any input parameter, it's complete virtual function
     virtual bool ClearTable() = 0; // ClearTable may be different for 1dTable and 2dTable
 
     // Three main search index functions
-    std::size_t SearchIndex(const double &value, const Eigen::RowVectorXd &table, const SearchMethod &method, const std::size_t &last_index = 0);
+    std::size_t SearchIndex(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const SearchMethod &method, const std::size_t &last_index = 0) const;
+    std::size_t SearchSequential(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table) const;
+    std::size_t SearchBinary(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table) const;
+    std::size_t SearchNear(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const std::size_t &last_index) const;
+    std::size_t SearchUniform(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator) const;
+    std::size_t SearchEytzinger(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator) const;
+    std::size_t SearchGallop(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const std::size_t &start_index) const;
+    std::size_t SearchAdaptive(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator, const std::size_t &last_index, AdaptiveState &state) const;
+
+    // Search on a table axis, evenly spaced axes use SearchUniform whatever the configured method. When the axis has
+    // an Eytzinger index, binary search uses it, and so does near search for a value more than near_window_
+    // breakpoints away from the last index, so the long jumps of a cursor after its first lookup stay logarithmic.
+    std::size_t SearchAxis(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator, const SearchMethod &method, const std::size_t &last_index) const
+    {
+        const bool indexed = accelerator.eytzinger && (method == SearchMethod::bin || (method == SearchMethod::near && !InNearWindow(value, table, last_index)));
+        const std::size_t index = accelerator.uniform ? SearchUniform(value, table, accelerator)
+                                  : indexed           ? SearchEytzinger(value, table, accelerator)
+                                                      : SearchIndex(value, table, method, last_index);
+        RecordSearch(index, last_index, table.size(), !accelerator.uniform && !indexed && (method == SearchMethod::near || method == SearchMethod::adaptive));
+        return index;
+    }
+    // Same with the statistics of the adaptive method, which SearchIndex alone runs as a plain galloping search
+    std::size_t SearchAxis(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator, const SearchMethod &method, const std::size_t &last_index, AdaptiveState &state) const
+    {
+        if (accelerator.uniform || method != SearchMethod::adaptive)
+        {
+            return SearchAxis(value, table, accelerator, method, last_index);
+        }
+        return SearchAdaptive(value, table, accelerator, last_index, state); // records its search, a fallback is no walk
+    }
+
+    // Merge step of sorted lookups, walks the axis from index to the SearchBinary result. A sorted sequence of m values
+    // costs O(n + m) over an axis of n breakpoints, a value below the previous one walks back.
+    std::size_t SearchMerge(const double &value, const double *axis, const std::size_t &size, const std::size_t &last_index) const
+    {
+        std::size_t index = std::min(std::max(last_index, std::size_t(1)), size - 1);
+        if (value <= axis[0])
+        {
+            index = 0;
+        }
+        else if (value >= axis[size - 1])
+        {
+            index = size;
+        }
+        else if (value != value)
+        {
+            index = size - 1; // NaN, same as SearchBinary
+        }
+        else
+        {
+            while (value > axis[index])
+            {
+                ++index;
+            }
+            while (value <= axis[index - 1])
+            {
+                --index;
+            }
+        }
+        RecordSearch(index, last_index, size, true);
+        return index;
+    }
+
+    // Method used after the first search, the adaptive method stays adaptive and every other method becomes near
+    SearchMethod NextSearchMethod(const SearchMethod &method) const { return method == SearchMethod::adaptive ? method : SearchMethod::near; }
 
     // Report error in case of fault
     bool ReportError();
 
+    // Lookup statistics of this table, zero with enabled false when built without LOOKUP_TABLE_STATISTICS
+#ifdef LOOKUP_TABLE_STATISTICS
+    LookupStatisticsSnapshot statistics() const { return statistics_.Snapshot(); }
+    void ResetStatistics() { statistics_.Reset(); }
+#else
+    LookupStatisticsSnapshot statistics() const { return LookupStatisticsSnapshot(); }
+    void ResetStatistics() {}
+#endif
+
 protected:
     // Common member variables for table configuration
     bool table_empty_ = true;
@@ -120,13 +279,71 @@ protected:
     // Important threthold
     double epsilon_ = std::numeric_limits<double>::epsilon();
     const std::size_t max_table_size_ = 1000000U; // do not exceed 1M, uint32_t can support up to 4294967295U.
+    static constexpr std::size_t axis_index_min_size_ = 4096U; // smaller axes stay in cache, the flat binary search is enough
+    static constexpr std::size_t near_window_ = 16U;            // breakpoints a near search walks before an indexed axis jumps
+
+    // True if value lies within near_window_ breakpoints on either side of an inner last_index
+    bool InNearWindow(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const std::size_t &last_index) const
+    {
+        const std::size_t size = table.size();
+        if (last_index == 0 || last_index >= size)
+        {
+            return false;
+        }
+        const std::size_t lower = last_index > near_window_ ? last_index - near_window_ : 0;
+        const std::size_t upper = std::min(last_index + near_window_, size - 1);
+        return value > table(lower) && value <= table(upper);
+    }
+    bool axis_index_enabled_ = true;
+    bool segment_coeffs_enabled_ = false;
+
+    // Instrumentation hooks, they compile to nothing without LOOKUP_TABLE_STATISTICS. Lookups keep the timer of
+    // StartLookupTimer alive for their whole body, batch lookups count their inputs with CountLookups.
+#ifdef LOOKUP_TABLE_STATISTICS
+    mutable LookupStatistics statistics_;
+    typedef LookupStatistics::Timer LookupTimer;
+    LookupTimer StartLookupTimer() const { return statistics_.StartLookup(); }
+    void CountLookups(const std::size_t &count) const { statistics_.RecordLookups(count); }
+    void RecordSearch(const std::size_t &index, const std::size_t &last_index, const std::size_t &size, const bool &walked) const
+    {
+        statistics_.RecordSearch(index, last_index, size, walked, static_cast<int>(extrap_method_));
+    }
+    void RecordFallback() const { statistics_.RecordFallback(); }
+#else
+    struct LookupTimer
+    {
+        ~LookupTimer() {} // user-provided, so an unused timer variable is not reported
+    };
+    LookupTimer StartLookupTimer() const { return LookupTimer(); }
+    void CountLookups(const std::size_t &) const {}
+    void RecordSearch(const std::size_t &, const std::size_t &, const std::size_t &, const bool &) const {}
+    void RecordFallback() const {}
+#endif
+
+    // Batch lookup works on blocks of samples, the block arrays live on the stack and are vectorized by Eigen
+    static constexpr std::size_t batch_block_size_ = 64U;
+    typedef Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, batch_block_size_, 1> BatchArray;
 
     // Functions commonly used
-    bool isStrictlyIncreasing(const Eigen::RowVectorXd &input_vector);
+    bool isStrictlyIncreasing(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector);
+    Monotonicity CheckMonotonicity(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector);
+    AxisAccelerator BuildAxisAccelerator(const Eigen::Ref<const Eigen::RowVectorXd> &axis) const;
+    std::shared_ptr<SegmentCoefficients> AllocateSegmentCoefficients(const std::size_t &count, const std::size_t &stride) const;
 
     // Convert Eigen::Index (long int) type to std::size_t (unsigned long int), avoid negative integers
     inline std::size_t ConvertSizeDataType(const Eigen::Index &eigen_index) { return static_cast<std::size_t>(std::max(eigen_index, Eigen::Index(0))); }
 
+    // Spline support, node slopes of y over x for the spline methods, computed once when the table is assigned
+    bool isSplineMethod(const InterpMethod &method) const { return method == InterpMethod::cubic || method == InterpMethod::pchip || method == InterpMethod::akima; }
+    Eigen::RowVectorXd SplineSlopes(const Eigen::RowVectorXd &x, const Eigen::RowVectorXd &y, const InterpMethod &method) const;
+    // Cubic Hermite basis at weight in [0 1] of a segment with given step, linear weights if spline is false
+    void HermiteBasis(const double &weight, const double &step, const bool &spline, double *value_basis, double *slope_basis) const;
+    // Derivatives of the same bases over the axis value (not the weight)
+    void HermiteBasisDerivative(const double &weight, const double &step, const bool &spline, double *value_basis, double *slope_basis) const;
+
+    // Weight of value within [x1 x2], same as in Interpolate
+    double Weight(const double &value, const double &x1, const double &x2) const { return std::abs(x2 - x1) < epsilon_ ? 0.5 : (value - x1) / (x2 - x1); }
+
     // Interpolation basic form
     double Interpolate(const double &xvalue, const double &x1, const double &x2, const double &y1, const double y2) const;
     double Interpolate(const double &rvalue, const double &cvalue,
@@ -134,4 +351,81 @@ protected:
                          const double &c1, const double &c2,
                          const double &m11, const double &m12,
                          const double &m21, const double &m22) const;
+
+    // Interpolation or extrapolation of a searched 1D index with every method but the splines, which act as linear.
+    // Shared by the 1D tables, views, compact tables and the multi table: value(i) reads breakpoint i from the
+    // caller's storage, the specified end values and the result are scalars or whole columns. The result keeps its
+    // value for an unknown method.
+    template <typename Value, typename EndValue, typename Result>
+    void EvaluateSegment(const std::size_t &index, const std::size_t &size, const double &xvalue, const double *axis, const Value &value,
+                         const EndValue &lower_value, const EndValue &upper_value, Result &&result) const
+    {
+        const std::size_t segment = std::min(std::max(index, std::size_t(1)), size - 1);
+        const double &x1 = axis[segment - 1];
+        const double &x2 = axis[segment];
+        if (index == 0 || index == size)
+        {
+            switch (extrap_method_)
+            {
+            case ExtrapMethod::clip:
+                result = value(index == 0 ? 0 : size - 1);
+                break;
+            case ExtrapMethod::linear:
+                result = value(segment - 1) + Weight(xvalue, x1, x2) * (value(segment) - value(segment - 1));
+                break;
+            case ExtrapMethod::specify:
+                result = index == 0 ? lower_value : upper_value;
+                break;
+            default:
+                break;
+            }
+            return;
+        }
+        switch (interp_method_)
+        {
+        case InterpMethod::nearest:
+            result = ((xvalue - x1) <= (x2 - xvalue)) ? value(segment - 1) : value(segment);
+            break;
+        case InterpMethod::next:
+            result = value(segment);
+            break;
+        case InterpMethod::previous:
+            result = value(segment - 1);
+            break;
+        case InterpMethod::linear:
+        case InterpMethod::cubic:
+        case InterpMethod::pchip:
+        case InterpMethod::akima:
+            result = value(segment - 1) + Weight(xvalue, x1, x2) * (value(segment) - value(segment - 1));
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Bilinear interpolation of a searched 2D cell, indices out of range are clipped to the border breakpoint and the
+    // remaining axis is interpolated. value(row, col) reads the map in the caller's layout and storage.
+    template <typename Value>
+    double EvaluateCell(const std::size_t &rindex, const std::size_t &cindex, const std::size_t &rsize, const std::size_t &csize, const double &rvalue, const double &cvalue,
+                        const double *row_axis, const double *col_axis, const Value &value) const
+    {
+        const bool row_inside = rindex > 0 && rindex < rsize;
+        const bool col_inside = cindex > 0 && cindex < csize;
+        const std::size_t row = rindex < 1 ? 0 : rsize - 1;
+        const std::size_t col = cindex < 1 ? 0 : csize - 1;
+        if (row_inside && col_inside)
+        {
+            return Interpolate(rvalue, cvalue, row_axis[rindex - 1], row_axis[rindex], col_axis[cindex - 1], col_axis[cindex],
+                               value(rindex - 1, cindex - 1), value(rindex - 1, cindex), value(rindex, cindex - 1), value(rindex, cindex));
+        }
+        else if (row_inside)
+        {
+            return Interpolate(rvalue, row_axis[rindex - 1], row_axis[rindex], value(rindex - 1, col), value(rindex, col));
+        }
+        else if (col_inside)
+        {
+            return Interpolate(cvalue, col_axis[cindex - 1], col_axis[cindex], value(row, cindex - 1), value(row, cindex));
+        }
+        return value(row, col);
+    }
 };
\ No newline at end of file
@@ -13,20 +13,67 @@ public:
     LookupTable1D(const std::size_t &size) : x_axis_{Eigen::RowVectorXd::LinSpaced(size,1,size)}, y_table_{Eigen::RowVectorXd::Zero(size)} {}
     LookupTable1D(const Eigen::RowVectorXd &x_axis, const Eigen::RowVectorXd &y_table) { AssignmentState assigned = AssignTableData(x_axis, y_table); }
     LookupTable1D(const std::vector<double> &x_vec, const std::vector<double> &y_vec) { AssignmentState assigned = AssignTableData(x_vec, y_vec); }
+    LookupTable1D(Eigen::RowVectorXd &&x_axis, Eigen::RowVectorXd &&y_table) { AssignmentState assigned = AssignTableData(std::move(x_axis), std::move(y_table)); }
     ~LookupTable1D() = default;
 
     // Get table state
     std::size_t size() const { return table_size_; }
+    const Eigen::RowVectorXd &x_axis() const { return x_axis_; }
+    const Eigen::RowVectorXd &y_table() const { return y_table_; }
+    double lower_extrap_value() const { return lower_extrap_value_specify_; }
+    double upper_extrap_value() const { return upper_extrap_value_specify_; }
 
     // Set and clear the table values
     AssignmentState AssignTableData(const Eigen::RowVectorXd &x_axis, const Eigen::RowVectorXd &y_table);
     AssignmentState AssignTableData(const std::vector<double> &x_vec, const std::vector<double> &y_vec);
+    // Take over the buffers of valid data without copying, invalid data is left with the caller
+    AssignmentState AssignTableData(Eigen::RowVectorXd &&x_axis, Eigen::RowVectorXd &&y_table);
     bool ClearTable() override;
+    // State the data would have after AssignTableData, the table is not changed
+    TableState CheckTableState(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector1, const Eigen::Ref<const Eigen::RowVectorXd> &input_vector2);
 
     // Lookup table based on input, using current search, interp, and extrap methods
     double Lookup(const double &xvalue);
 
-    // Configure the methods
+    // Batch lookup into a caller-provided buffer, results are identical to calling Lookup one sample at a time
+    void Lookup(const double *xvalues, double *results, const std::size_t &count);
+    void Lookup(const std::vector<double> &xvalues, std::vector<double> &results);
+    void Lookup(const Eigen::Ref<const Eigen::RowVectorXd> &xvalues, Eigen::Ref<Eigen::RowVectorXd> results);
+
+    // Thread-safe lookup, the table is not modified and the search state lives in the caller's cursor
+    double Lookup(const double &xvalue, LookupCursor &cursor) const;
+    void Lookup(const double *xvalues, double *results, const std::size_t &count, LookupCursor &cursor) const;
+    void Lookup(const std::vector<double> &xvalues, std::vector<double> &results, LookupCursor &cursor) const;
+
+    // Lookup of sorted inputs, the axis and the inputs are walked together in one merge pass: O(n + m) for n breakpoints
+    // and m inputs over all calls that continue with the same cursor. Unsorted inputs give the same results, only slower.
+    void LookupSorted(const double *xvalues, double *results, const std::size_t &count);
+    void LookupSorted(const double *xvalues, double *results, const std::size_t &count, LookupCursor &cursor) const;
+    void LookupSorted(const std::vector<double> &xvalues, std::vector<double> &results, LookupCursor &cursor) const;
+
+    // Value and derivative dy/dx with one search, the value equals Lookup. The derivative is the one of the configured
+    // interpolation, one-sided (left segment) on a breakpoint, 0 for nearest, next, and previous, and 0 outside the
+    // axis except with linear extrapolation.
+    double LookupGradient(const double &xvalue, double &derivative);
+    double LookupGradient(const double &xvalue, double &derivative, LookupCursor &cursor) const;
+    void LookupGradient(const double *xvalues, double *results, double *derivatives, const std::size_t &count);
+    void LookupGradient(const double *xvalues, double *results, double *derivatives, const std::size_t &count, LookupCursor &cursor) const;
+
+    // Inverse lookup of a strictly monotone y table, solves x from y with one search over the y values and the inverse
+    // of linear interpolation. y beyond the table range gives the end x values, or extends the end segments with
+    // ExtrapMethod::linear. Spline tables are inverted through their breakpoints. The last result is returned while the
+    // table is not monotone. Keep separate cursors for forward and inverse lookups, they search different axes.
+    Monotonicity monotonicity() const { return y_monotonicity_; }
+    double InverseLookup(const double &yvalue);
+    double InverseLookup(const double &yvalue, LookupCursor &cursor) const;
+
+    // Interpolate with the result of a Prelookup on an axis of the same size, no search is done
+    double Lookup(const PrelookupResult &prelookup) const;
+
+    // Configure the methods, spline methods build their segment coefficients here or when data is assigned
+    void SetInterpMethod(const InterpMethod &method) override;
+    void SetAxisIndex(const bool &enable) override;
+    void SetSegmentCoefficients(const bool &enable) override;
     void SetExtrapMethod(const ExtrapMethod &method);
     void SetExtrapMethod(const ExtrapMethod &method, const double &lower_value, const double &upper_value);
     void SetLowerExtrapValue(const double &value) { lower_extrap_value_specify_ = value; }
@@ -43,24 +90,42 @@ private:
     std::size_t table_size_ = 0U; // length of table
     double lower_extrap_value_specify_ = 0; // user specified value for out of boundary look up
     double upper_extrap_value_specify_ = 0; // user specified value for out of boundary look up
+    AxisAccelerator x_accelerator_;         // direct indexing for evenly spaced x axis
+    AdaptiveState x_adaptive_;              // statistics of SearchMethod::adaptive
+    // Spline coefficients, column (index - 1) holds y = a + t * (b + t * (c + t * d)) with t = x - x(index - 1)
+    Eigen::Matrix<double, 4, Eigen::Dynamic> spline_coeffs_;
+    // Linear coefficients, segment (index - 1) holds y = y(index - 1) + slope * (x - x(index - 1)), empty unless enabled
+    std::shared_ptr<const SegmentCoefficients> linear_coeffs_;
+
+    // Inverse lookup, the y values in increasing order and the matching x values, empty unless y is monotone
+    Monotonicity y_monotonicity_ = Monotonicity::none;
+    Eigen::RowVectorXd inverse_axis_;
+    Eigen::RowVectorXd inverse_values_;
+    AxisAccelerator inverse_accelerator_;
+    std::size_t inverse_index_ = 0;     // restore inverse prelook index value
+    bool inverse_primed_ = false;       // false until the first inverse lookup
+    AdaptiveState inverse_adaptive_;
+    double inverse_result_ = 0;         // restore inverse output value
 
     // Methods for checking tables
     bool RefreshTableState();
-    TableState CheckTableState(const Eigen::RowVectorXd &input_vector1, const Eigen::RowVectorXd &input_vector2);
 
     // Prelookup to find the index of the input value
     std::size_t PreLookup(const double &xvalue);
+    void LookupBatch(const double *xvalues, double *results, const std::size_t &count, const SearchMethod &first_method, std::size_t &index, AdaptiveState &adaptive) const;
 
     // Interpolation between the two closest points
-    double Interpolation(const std::size_t &prelookup_index, const double &xvalue);
-    double InterpolationLinear(const std::size_t &prelookup_index, const double &xvalue);
-    double InterpolationNearest(const std::size_t &prelookup_index, const double &xvalue);
-    double InterpolationNext(const std::size_t &prelookup_index, const double &xvalue);
-    double InterpolationPrevious(const std::size_t &prelookup_index, const double &xvalue);
+    double Interpolation(const std::size_t &prelookup_index, const double &xvalue) const;
+    double InterpolationSpline(const std::size_t &prelookup_index, const double &xvalue) const;
+    void BuildSplineCoefficients();
+    void BuildLinearCoefficients();
+    void BuildInverse();
+    double InverseInterpolation(const std::size_t &index, const double &yvalue) const;
+    double Derivative(const std::size_t &prelookup_index, const double &xvalue) const;
+    void LookupMergeBatch(const double *xvalues, double *results, const std::size_t &count, std::size_t &index) const;
+    void LookupGradientBatch(const double *xvalues, double *results, double *derivatives, const std::size_t &count, const SearchMethod &first_method, std::size_t &index, AdaptiveState &adaptive) const;
+    void InterpolationBatch(const std::size_t *prelookup_index, const double *xvalues, double *results, const std::size_t &count) const;
 
     // Extrapolation if input is out of bounds
-    double Extrapolation(const std::size_t &prelookup_index, const double &xvalue);
-    double ExtrapolationClip(const std::size_t &prelookup_index);
-    double ExtrapolationLinear(const std::size_t &prelookup_index, const double &xvalue);
-    double ExtrapolationSpecify(const std::size_t &prelookup_index, const double &lower_extrap_value, const double &upper_extrap_value);
+    double Extrapolation(const std::size_t &prelookup_index, const double &xvalue) const;
 };
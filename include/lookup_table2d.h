@@ -9,23 +9,74 @@ public:
     // Constructors and destructors
     LookupTable2D() = default;
     LookupTable2D(const std::size_t &rows, const std::size_t &cols) : row_axis_{Eigen::RowVectorXd::LinSpaced(rows, 1, rows)}, col_axis_{Eigen::RowVectorXd::LinSpaced(cols, 1, cols)}, map_matrix_{Eigen::MatrixXd::Zero(rows, cols)} {}
-    LookupTable2D(const Eigen::RowVectorXd row_axis, const Eigen::RowVectorXd col_axis, const Eigen::MatrixXd &map_matrix) { table_assigned_ = AssignTableData(row_axis, col_axis, map_matrix); }
+    LookupTable2D(const Eigen::RowVectorXd &row_axis, const Eigen::RowVectorXd &col_axis, const Eigen::MatrixXd &map_matrix) { table_assigned_ = AssignTableData(row_axis, col_axis, map_matrix); }
     LookupTable2D(const std::vector<double> &row_axis, const std::vector<double> &col_axis, const std::vector<double> &map_matrix) { table_assigned_ = AssignTableData(row_axis, col_axis, map_matrix); }
+    LookupTable2D(Eigen::RowVectorXd &&row_axis, Eigen::RowVectorXd &&col_axis, Eigen::MatrixXd &&map_matrix) { table_assigned_ = AssignTableData(std::move(row_axis), std::move(col_axis), std::move(map_matrix)); }
     ~LookupTable2D() = default;
 
     // Get table state
     MatrixIndex size() const { return table_size_; }
     std::size_t rows() const { return table_size_.rows(); }
     std::size_t cols() const { return table_size_.cols(); }
+    const Eigen::RowVectorXd &row_axis() const { return row_axis_; }
+    const Eigen::RowVectorXd &col_axis() const { return col_axis_; }
+    const Eigen::MatrixXd &map_matrix() const { return map_matrix_; }
+    InterpMethod row_interp_method() const { return row_interp_method_; }
+    InterpMethod col_interp_method() const { return col_interp_method_; }
 
     // Set and clear the table values
     AssignmentState AssignTableData(const Eigen::RowVectorXd &row_axis, const Eigen::RowVectorXd &col_axis, const Eigen::MatrixXd &mat_matrix);
     AssignmentState AssignTableData(const std::vector<double> &row_vec, const std::vector<double> &col_vec, const std::vector<double> &map_vec);
+    // Take over the buffers of valid data without copying, invalid data is left with the caller
+    AssignmentState AssignTableData(Eigen::RowVectorXd &&row_axis, Eigen::RowVectorXd &&col_axis, Eigen::MatrixXd &&map_matrix);
     bool ClearTable() override;
+    // State the data would have after AssignTableData, the table is not changed
+    TableState CheckTableState(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector1, const Eigen::Ref<const Eigen::RowVectorXd> &input_vector2, const Eigen::Index &rows, const Eigen::Index &cols);
 
     // Lookup table based on input, using current search, interp, and extrap methods
     double Lookup(const double &rvalue, const double &cvalue);
 
+    // Batch lookup over (row, col) pairs into a caller-provided buffer, results are identical to calling Lookup per pair
+    void Lookup(const double *rvalues, const double *cvalues, double *results, const std::size_t &count);
+    void Lookup(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results);
+    void Lookup(const Eigen::Ref<const Eigen::RowVectorXd> &rvalues, const Eigen::Ref<const Eigen::RowVectorXd> &cvalues, Eigen::Ref<Eigen::RowVectorXd> results);
+
+    // Thread-safe lookup, the table is not modified and the search state lives in the caller's cursor
+    double Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const;
+    void Lookup(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, LookupCursor &cursor) const;
+    void Lookup(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results, LookupCursor &cursor) const;
+
+    // Configure the methods per axis, linear or one of the spline methods, other methods act as linear
+    void SetInterpMethod(const InterpMethod &method) override;
+    void SetAxisIndex(const bool &enable) override;
+    void SetSegmentCoefficients(const bool &enable) override;
+    void SetInterpMethod(const InterpMethod &row_method, const InterpMethod &col_method);
+
+    // Lookup of inputs sorted along each axis (a sweep or a replayed signal), both axes are walked together with their
+    // inputs in merge passes, O(rows + cols + m) over all calls with the same cursor. Other inputs give the same
+    // results, only slower.
+    void LookupSorted(const double *rvalues, const double *cvalues, double *results, const std::size_t &count);
+    void LookupSorted(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, LookupCursor &cursor) const;
+    void LookupSorted(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results, LookupCursor &cursor) const;
+
+    // Value and partial derivatives dz/dr and dz/dc with one search, the value equals Lookup. The derivatives are the
+    // ones of the per-axis interpolation, one-sided (lower cell) on a breakpoint, and 0 along a clipped axis.
+    double LookupGradient(const double &rvalue, const double &cvalue, double &row_derivative, double &col_derivative);
+    double LookupGradient(const double &rvalue, const double &cvalue, double &row_derivative, double &col_derivative, LookupCursor &cursor) const;
+    void LookupGradient(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count);
+    void LookupGradient(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count, LookupCursor &cursor) const;
+
+    // Inverse lookup along the column axis, solves the column value from a row value and a map value when every row of
+    // the map is strictly monotone in the same direction. The row is interpolated linearly (clipped outside the row
+    // axis), then the map values along the columns are searched and linear interpolation is inverted. Map values
+    // beyond the interpolated row give the end column values. The last result is returned while the map is not monotone.
+    Monotonicity col_monotonicity() const { return col_monotonicity_; }
+    double InverseLookup(const double &rvalue, const double &zvalue);
+    double InverseLookup(const double &rvalue, const double &zvalue, LookupCursor &cursor) const;
+
+    // Interpolate with the results of Prelookup on axes of the same sizes, no search is done
+    double Lookup(const PrelookupResult &row_prelookup, const PrelookupResult &col_prelookup) const;
+
 private:
     // Core members
     Eigen::RowVectorXd row_axis_; // the row axis
@@ -37,17 +88,50 @@ private:
     MatrixIndex prelook_index_{0, 0};
     // Table state members
     MatrixIndex table_size_{0, 0};
+    AxisAccelerator row_accelerator_; // direct indexing for evenly spaced row axis
+    AxisAccelerator col_accelerator_; // direct indexing for evenly spaced column axis
+    AdaptiveState row_adaptive_;      // statistics of SearchMethod::adaptive on the row axis
+    AdaptiveState col_adaptive_;      // statistics of SearchMethod::adaptive on the column axis
+    // Spline slopes at every breakpoint, only built for the axes that use a spline method
+    InterpMethod row_interp_method_ = InterpMethod::linear;
+    InterpMethod col_interp_method_ = InterpMethod::linear;
+    Eigen::MatrixXd row_slopes_;   // dz/dr
+    Eigen::MatrixXd col_slopes_;   // dz/dc
+    Eigen::MatrixXd cross_slopes_; // d2z/drdc, when both axes use splines
+    // Bilinear coefficients, cell (rindex - 1) * (cols - 1) + (cindex - 1) holds z = a + b * dr + (c + d * dr) * dc
+    // with dr and dc measured from the first corner of the cell, empty unless enabled
+    std::shared_ptr<const SegmentCoefficients> cell_coeffs_;
+
+    // Inverse lookup along the columns
+    Monotonicity col_monotonicity_ = Monotonicity::none;
+    std::size_t inverse_row_ = 0;  // restore row prelook index of the inverse lookup
+    bool inverse_primed_ = false;  // false until the first inverse lookup
+    AdaptiveState inverse_adaptive_;
+    double inverse_result_ = 0;    // restore inverse output value
 
     // Methods for checking tables
     bool RefreshTableState();
-    TableState CheckTableState(const Eigen::RowVectorXd &input_vector1, const Eigen::RowVectorXd &input_vector2, const Eigen::MatrixXd &input_matrix);
 
     // Prelookup to find the index of the input value
     MatrixIndex PreLookup(const double &row_value, const double &col_value);
+    void LookupBatch(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, const SearchMethod &first_method,
+                     std::size_t &row, std::size_t &col, AdaptiveState &row_adaptive, AdaptiveState &col_adaptive) const;
 
     // Interpolation between the two closest points
-    double Interpolation(const MatrixIndex &prelookup_index, const double &row_value, const double &col_value);
+    double Interpolation(const MatrixIndex &prelookup_index, const double &row_value, const double &col_value) const;
+    double InterpolationSpline(const std::size_t &rindex, const std::size_t &cindex, const double &rweight, const double &cweight) const;
+    double InterpolationAlongRow(const std::size_t &rindex, const std::size_t &col, const double &rweight) const;
+    double InterpolationAlongCol(const std::size_t &row, const std::size_t &cindex, const double &cweight) const;
+    void BuildSplineSlopes();
+    void BuildCellCoefficients();
+    void BuildInverse();
+    double InverseAlongCol(const std::size_t &rindex, const double &rvalue, const double &zvalue, std::size_t &cindex) const;
+    void LookupMergeBatch(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, std::size_t &row, std::size_t &col) const;
+    void Gradient(const MatrixIndex &prelookup_index, const double &row_value, const double &col_value, double &row_derivative, double &col_derivative) const;
+    void LookupGradientBatch(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count,
+                             const SearchMethod &first_method, std::size_t &row, std::size_t &col, AdaptiveState &row_adaptive, AdaptiveState &col_adaptive) const;
+    void InterpolationBatch(const std::size_t *row_index, const std::size_t *col_index, const double *row_values, const double *col_values, double *results, const std::size_t &count) const;
 
     // Extrapolation if input is out of bounds, only support clip method
-    double Extrapolation(const MatrixIndex &prelookup_index, const double &row_value, const double &col_value);
+    double Extrapolation(const MatrixIndex &prelookup_index, const double &row_value, const double &col_value) const;
 };
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+#include <Eigen/Dense>
+#include "lookup_table.h"
+#include "lookup_table2d.h"
+
+class CalibrationFile;
+class CalibrationFileWriter;
+
+// Non-owning tables over memory that outlives them, e.g. a memory-mapped calibration file. Only the data pointers
+// are stored, the axes and values are accessed through Eigen::Map and nothing is copied. Views support the basic
+// interpolation methods. The spline methods need slopes that a view does not have, a view set to one of them is
+// invalid until it is set back.
+class LookupTable1DView : public LookupTable
+{
+public:
+    typedef Eigen::Map<const Eigen::RowVectorXd> AxisMap;
+
+    // Constructors and destructor
+    LookupTable1DView() = default;
+    LookupTable1DView(const double *x_axis, const double *y_table, const std::size_t &size) { table_assigned_ = AttachTableData(x_axis, y_table, size); }
+    ~LookupTable1DView() = default;
+
+    // Get table state
+    std::size_t size() const { return table_size_; }
+    AxisMap x_axis() const { return AxisMap(x_axis_, table_size_); }
+    AxisMap y_table() const { return AxisMap(y_table_, table_size_); }
+    double lower_extrap_value() const { return lower_extrap_value_specify_; }
+    double upper_extrap_value() const { return upper_extrap_value_specify_; }
+
+    // Attach to external memory after validating it, the memory must stay alive while the view is used
+    AssignmentState AttachTableData(const double *x_axis, const double *y_table, const std::size_t &size);
+    bool ClearTable() override;
+
+    // Lookup table based on input, using current search, interp, and extrap methods
+    double Lookup(const double &xvalue);
+    double Lookup(const double &xvalue, LookupCursor &cursor) const;
+
+    // Configure the methods
+    void SetInterpMethod(const InterpMethod &method) override;
+    void SetExtrapMethod(const ExtrapMethod &method, const double &lower_value, const double &upper_value);
+
+private:
+    friend class CalibrationFile;
+    friend class CalibrationFileWriter;
+
+    // Core members
+    const double *x_axis_ = nullptr;
+    const double *y_table_ = nullptr;
+    double lookup_result_ = 0;      // restore output value.
+    std::size_t prelook_index_ = 0; // restore prelook index value.
+    // Other parameters
+    std::size_t table_size_ = 0U;
+    double lower_extrap_value_specify_ = 0;
+    double upper_extrap_value_specify_ = 0;
+    AxisAccelerator x_accelerator_;
+
+    // Attach without validation, for data that was validated when it was written along with its accelerator
+    void Attach(const double *x_axis, const double *y_table, const std::size_t &size, const AxisAccelerator &x_accelerator);
+
+    // Valid while data is attached and the interp method is not a spline
+    void RefreshValid() { table_valid_ = y_table_ != nullptr && !isSplineMethod(interp_method_); }
+
+    // Interpolation or extrapolation for a searched index
+    double Evaluate(const std::size_t &index, const double &xvalue, const double &fallback) const;
+};
+
+// The map is stored row by row by default, the same order as the std::vector constructor of LookupTable2D, or column
+// by column like Eigen::MatrixXd. Both layouts are read in place through strides, so nothing is transposed.
+// Like LookupTable2D, extrapolation is clip and the methods other than the splines act as linear. As for the 1D view,
+// a spline method on either axis makes the view invalid.
+class LookupTable2DView : public LookupTable
+{
+public:
+    enum class Layout
+    {
+        row_major = 0,
+        col_major = 1
+    };
+    typedef Eigen::Map<const Eigen::RowVectorXd> AxisMap;
+    typedef Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>> MapMatrix;
+
+    // Constructors and destructor
+    LookupTable2DView() = default;
+    LookupTable2DView(const double *row_axis, const double *col_axis, const double *map_data, const std::size_t &rows, const std::size_t &cols, const Layout &layout = Layout::row_major)
+    {
+        table_assigned_ = AttachTableData(row_axis, col_axis, map_data, rows, cols, layout);
+    }
+    // View over the buffers of a table, which must outlive the view and keep its data. The view takes the methods of
+    // the table, so it is invalid for a spline table.
+    explicit LookupTable2DView(const LookupTable2D &table)
+    {
+        table_assigned_ = AttachTableData(table.row_axis().data(), table.col_axis().data(), table.map_matrix().data(), table.rows(), table.cols(), Layout::col_major);
+        SetSearchMethod(table.search_method());
+        SetExtrapMethod(table.extrap_method());
+        SetInterpMethod(table.row_interp_method(), table.col_interp_method());
+    }
+    ~LookupTable2DView() = default;
+
+    // Get table state
+    MatrixIndex size() const { return table_size_; }
+    std::size_t rows() const { return table_size_.rows(); }
+    std::size_t cols() const { return table_size_.cols(); }
+    AxisMap row_axis() const { return AxisMap(row_axis_, table_size_.rows()); }
+    AxisMap col_axis() const { return AxisMap(col_axis_, table_size_.cols()); }
+    Layout layout() const { return layout_; }
+    MapMatrix map_matrix() const { return MapMatrix(map_data_, table_size_.rows(), table_size_.cols(), Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(col_stride_, row_stride_)); }
+    InterpMethod row_interp_method() const { return row_interp_method_; }
+    InterpMethod col_interp_method() const { return col_interp_method_; }
+
+    // Attach to external memory after validating it, the memory must stay alive while the view is used
+    AssignmentState AttachTableData(const double *row_axis, const double *col_axis, const double *map_data, const std::size_t &rows, const std::size_t &cols,
+                                    const Layout &layout = Layout::row_major);
+    bool ClearTable() override;
+
+    // Lookup table based on input, using current search and interp methods
+    double Lookup(const double &rvalue, const double &cvalue);
+    double Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const;
+
+    // Configure the methods per axis like LookupTable2D
+    void SetInterpMethod(const InterpMethod &method) override;
+    void SetInterpMethod(const InterpMethod &row_method, const InterpMethod &col_method);
+
+private:
+    friend class CalibrationFile;
+    friend class CalibrationFileWriter;
+
+    // Core members
+    const double *row_axis_ = nullptr;
+    const double *col_axis_ = nullptr;
+    const double *map_data_ = nullptr;
+    double lookup_result_ = 0;
+    MatrixIndex prelook_index_{0, 0};
+    // Table state members
+    MatrixIndex table_size_{0, 0};
+    Layout layout_ = Layout::row_major;
+    InterpMethod row_interp_method_ = InterpMethod::linear;
+    InterpMethod col_interp_method_ = InterpMethod::linear;
+    std::size_t row_stride_ = 0; // distance between neighbouring rows of one column
+    std::size_t col_stride_ = 0; // distance between neighbouring columns of one row
+    AxisAccelerator row_accelerator_;
+    AxisAccelerator col_accelerator_;
+
+    // Attach without validation, for data that was validated when it was written along with its accelerators
+    void Attach(const double *row_axis, const double *col_axis, const double *map_data, const std::size_t &rows, const std::size_t &cols,
+                const AxisAccelerator &row_accelerator, const AxisAccelerator &col_accelerator, const Layout &layout = Layout::row_major);
+
+    // Valid while data is attached and neither axis uses a spline method
+    void RefreshValid() { table_valid_ = map_data_ != nullptr && !isSplineMethod(row_interp_method_) && !isSplineMethod(col_interp_method_); }
+
+    // Map value in either layout
+    double Value(const std::size_t &row, const std::size_t &col) const { return map_data_[row * row_stride_ + col * col_stride_]; }
+
+    // Interpolation or clip extrapolation for a searched cell
+    double Evaluate(const std::size_t &rindex, const std::size_t &cindex, const double &rvalue, const double &cvalue) const;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table.h"
+
+// N-dimensional table with multilinear interpolation. Other interp methods are ignored, interp_method() stays linear.
+class LookupTableND : public LookupTable
+{
+public:
+    // Constructors and destructors, data is stored with the last axis varying fastest
+    LookupTableND() = default;
+    LookupTableND(const std::vector<Eigen::RowVectorXd> &axes, const Eigen::VectorXd &data) { table_assigned_ = AssignTableData(axes, data); }
+    LookupTableND(const std::vector<std::vector<double>> &axes, const std::vector<double> &data) { table_assigned_ = AssignTableData(axes, data); }
+    ~LookupTableND() = default;
+
+    // Get table state
+    std::size_t dimensions() const { return axes_.size(); }
+    const std::vector<std::size_t> &size() const { return table_size_; }
+
+    // Set and clear the table values
+    AssignmentState AssignTableData(const std::vector<Eigen::RowVectorXd> &axes, const Eigen::VectorXd &data);
+    AssignmentState AssignTableData(const std::vector<std::vector<double>> &axes, const std::vector<double> &data);
+    bool ClearTable() override;
+
+    // Lookup table based on input, values holds one input per axis
+    double Lookup(const double *values);
+    double Lookup(const std::vector<double> &values);
+
+    // Batch lookup, points are stored one after another with dimensions() values each
+    void Lookup(const double *points, double *results, const std::size_t &count);
+    void Lookup(const std::vector<double> &points, std::vector<double> &results);
+
+    // Configure the methods, interpolation is always linear, extrapolation is set per axis and supports clip and
+    // linear (specify acts as clip)
+    void SetInterpMethod(const InterpMethod &method) override;
+    void SetExtrapMethod(const ExtrapMethod &method) override;
+    void SetExtrapMethod(const std::size_t &axis, const ExtrapMethod &method);
+
+    static constexpr std::size_t max_dimensions_ = 8U; // 2^8 corner cells per lookup
+
+private:
+    // Core members
+    std::vector<Eigen::RowVectorXd> axes_;
+    Eigen::VectorXd data_;
+    double lookup_result_ = 0;                // restore lookup result
+    std::vector<std::size_t> prelook_index_;  // restore prelook index of each axis
+    // Table state members
+    std::vector<std::size_t> table_size_;     // breakpoints of each axis
+    std::vector<std::size_t> strides_;        // distance in data_ between neighbouring breakpoints of each axis
+    std::vector<AxisAccelerator> accelerators_;
+    std::vector<ExtrapMethod> extrap_methods_;
+
+    // Methods for checking tables
+    bool RefreshTableState();
+    TableState CheckTableState(const std::vector<Eigen::RowVectorXd> &axes, const Eigen::VectorXd &data);
+
+    // Prelookup to find the index on every axis
+    void PreLookup(const double *values, const SearchMethod &method);
+
+    // Multilinear interpolation over the 2^N corners of the cell, extrapolation is folded into the axis weights
+    double Interpolation(const std::size_t *prelookup_index, const double *values) const;
+};
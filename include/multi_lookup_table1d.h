@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table.h"
+
+// One-dimensional table with many output channels over one breakpoint axis, e.g. per-cylinder trims over speed.
+// y_table_ has one row per channel and one column per breakpoint; Eigen stores it column by column, so the channels
+// of a breakpoint are contiguous. One search serves every channel, and the blend of the two breakpoint columns is
+// vectorized across the channels. Every channel gives the same result as a LookupTable1D of that row.
+// Spline methods act as linear.
+class MultiLookupTable1D : public LookupTable
+{
+public:
+    // Constructors and destructor
+    MultiLookupTable1D() = default;
+    MultiLookupTable1D(const Eigen::RowVectorXd &x_axis, const Eigen::MatrixXd &y_table) { table_assigned_ = AssignTableData(x_axis, y_table); }
+    ~MultiLookupTable1D() = default;
+
+    // Get table state
+    std::size_t size() const { return table_size_; }
+    std::size_t channels() const { return static_cast<std::size_t>(y_table_.rows()); }
+    const Eigen::RowVectorXd &x_axis() const { return x_axis_; }
+    const Eigen::MatrixXd &y_table() const { return y_table_; }
+    const Eigen::VectorXd &result() const { return lookup_result_; }
+
+    // Set and clear the table values, y_table has one row per channel and as many columns as x_axis
+    AssignmentState AssignTableData(const Eigen::RowVectorXd &x_axis, const Eigen::MatrixXd &y_table);
+    bool ClearTable() override;
+
+    // Lookup of all channels, using current search, interp, and extrap methods. The returned reference stays valid
+    // until the next lookup, the last results are kept while the table is invalid.
+    const Eigen::VectorXd &Lookup(const double &xvalue);
+
+    // Thread-safe lookup into a caller-provided vector of channels() values, left unchanged while the table is invalid
+    void Lookup(const double &xvalue, Eigen::Ref<Eigen::VectorXd> results, LookupCursor &cursor) const;
+
+    // Configure the extrapolation, specified values are given per channel
+    void SetExtrapMethod(const ExtrapMethod &method) override;
+    void SetExtrapMethod(const ExtrapMethod &method, const Eigen::VectorXd &lower_values, const Eigen::VectorXd &upper_values);
+
+private:
+    // Core members
+    Eigen::RowVectorXd x_axis_;
+    Eigen::MatrixXd y_table_;       // channels x breakpoints
+    Eigen::VectorXd lookup_result_; // restore output values
+    std::size_t prelook_index_ = 0; // restore prelook index value
+    // Other parameters
+    std::size_t table_size_ = 0U;
+    Eigen::VectorXd lower_extrap_values_; // user specified values for out of boundary look up
+    Eigen::VectorXd upper_extrap_values_;
+    AxisAccelerator x_accelerator_;
+    AdaptiveState x_adaptive_;
+
+    // Methods for checking tables
+    bool RefreshTableState();
+    TableState CheckTableState(const Eigen::RowVectorXd &x_axis, const Eigen::MatrixXd &y_table);
+
+    // Interpolation or extrapolation of all channels for a searched index
+    void Evaluate(const std::size_t &index, const double &xvalue, Eigen::Ref<Eigen::VectorXd> results) const;
+};
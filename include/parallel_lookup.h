@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Bulk evaluation of tables on a fixed pool of threads. The inputs are cut into chunks, every thread owns a
+// contiguous range of chunks and takes them from the front, and a thread that runs out steals the next chunks of the
+// other ranges. Each thread searches with its own cursor through the const lookups, so a table is never modified and
+// every result only depends on its input: the output is identical for any thread count and chunk size.
+// Chunks are batch lookups, set SearchMethod::adaptive on the table when the inputs jump around.
+class ParallelLookup
+{
+public:
+    // Work on the half-open input range [begin, end) with the cursor of the calling thread
+    typedef std::function<void(const std::size_t &begin, const std::size_t &end, LookupTable::LookupCursor &cursor)> RangeTask;
+
+    static constexpr std::size_t default_chunk_size_ = 4096U;
+
+    // Constructors and destructor, 0 threads uses every hardware thread. The calling thread works as well, so
+    // threads - 1 workers are started; they wait between runs and are joined by the destructor.
+    explicit ParallelLookup(const std::size_t &threads = 0, const std::size_t &chunk_size = default_chunk_size_);
+    ParallelLookup(const ParallelLookup &) = delete;
+    ParallelLookup &operator=(const ParallelLookup &) = delete;
+    ~ParallelLookup();
+
+    // Get pool state
+    std::size_t threads() const { return workers_.size() + 1; }
+    std::size_t chunk_size() const { return chunk_size_; }
+    std::size_t steals() const { return steals_.load(); } // chunks taken from another thread's range in the last run
+
+    // Lookup into a caller-provided buffer, same results as the batch lookup of the table
+    void Lookup(const LookupTable1D &table, const double *xvalues, double *results, const std::size_t &count);
+    void Lookup(const LookupTable1D &table, const std::vector<double> &xvalues, std::vector<double> &results);
+    void Lookup(const LookupTable2D &table, const double *rvalues, const double *cvalues, double *results, const std::size_t &count);
+    void Lookup(const LookupTable2D &table, const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results);
+
+    // Run a task over [0, count) in chunks and return when every chunk is done, runs from several threads are serialized
+    void Run(const std::size_t &count, const RangeTask &task);
+
+private:
+    // Chunks [next, end) of one thread, next only grows
+    struct alignas(64) WorkRange
+    {
+        std::atomic<std::size_t> next{0};
+        std::size_t end = 0;
+    };
+
+    const std::size_t chunk_size_;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<WorkRange[]> ranges_;
+    std::vector<LookupTable::LookupCursor> cursors_; // one per thread, reset at the start of every run
+    std::atomic<std::size_t> steals_{0};
+
+    std::mutex run_mutex_; // serializes Run
+    std::mutex mutex_;     // guards the run state below
+    std::condition_variable start_condition_;
+    std::condition_variable done_condition_;
+    std::uint64_t generation_ = 0; // counts runs, workers start when it changes
+    std::size_t pending_ = 0;      // workers still busy with the current run
+    bool stop_ = false;
+    const RangeTask *task_ = nullptr;
+    std::size_t count_ = 0;
+
+    void WorkerLoop(const std::size_t &thread);
+    void Work(const std::size_t &thread);
+};
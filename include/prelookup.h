@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table.h"
+
+// Breakpoint search shared by several tables on the same axis. The (index, fraction) result is passed to the
+// prelookup overloads of LookupTable1D::Lookup and LookupTable2D::Lookup, which interpolate without searching again.
+class Prelookup : public LookupTable
+{
+public:
+    // Constructors and destructors
+    Prelookup() = default;
+    Prelookup(const Eigen::RowVectorXd &axis) { table_assigned_ = AssignTableData(axis); }
+    Prelookup(const std::vector<double> &axis_vec) { table_assigned_ = AssignTableData(axis_vec); }
+    ~Prelookup() = default;
+
+    // Get table state
+    std::size_t size() const { return table_size_; }
+
+    // Set and clear the axis values
+    AssignmentState AssignTableData(const Eigen::RowVectorXd &axis);
+    AssignmentState AssignTableData(const std::vector<double> &axis_vec);
+    bool ClearTable() override;
+
+    // Search the axis and compute the fraction within the segment, the last result is returned while the axis is invalid
+    PrelookupResult Lookup(const double &value);
+    PrelookupResult Lookup(const double &value, LookupCursor &cursor) const;
+
+private:
+    // Core members
+    Eigen::RowVectorXd axis_;
+    PrelookupResult lookup_result_; // restore output value.
+    // Other parameters
+    std::size_t table_size_ = 0U;
+    AxisAccelerator accelerator_;
+
+    // Methods for checking tables
+    bool RefreshTableState();
+    TableState CheckTableState(const Eigen::RowVectorXd &input_vector);
+
+    // Fraction within the segment of the searched index
+    PrelookupResult Fraction(const std::size_t &index, const double &value) const;
+};
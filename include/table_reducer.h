@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Error-bounded breakpoint reduction. Over-sampled tables are replaced by a subset of their own breakpoints, kept
+// breakpoints keep their values, and every removed breakpoint is reproduced by linear (1D) or bilinear (2D)
+// interpolation within max(max_abs_error, max_rel_error * |value|). The reduced interpolant is linear between the
+// original breakpoints, so the bound holds for every input inside the axes. Extrapolation is not bounded, linear
+// extrapolation continues the new end segments. Tables with another interpolation method are returned unchanged.
+class TableReducer
+{
+public:
+    // Result of one reduction, errors are measured with Lookup at every original breakpoint and segment midpoint
+    struct ReductionReport
+    {
+        double max_abs_error = 0;        // largest absolute error
+        double max_rel_error = 0;        // largest error relative to the original value
+        std::size_t samples = 0;         // number of compared points
+        std::size_t original_rows = 0;   // breakpoints of the first axis before and after
+        std::size_t reduced_rows = 0;
+        std::size_t original_cols = 0;   // breakpoints of the second axis, 0 for 1D tables
+        std::size_t reduced_cols = 0;
+        std::size_t original_bytes = 0;  // memory of the axes and values
+        std::size_t reduced_bytes = 0;
+    };
+
+    // Constructors and destructor, negative tolerances count as 0
+    TableReducer() = default;
+    TableReducer(const double &max_abs_error, const double &max_rel_error = 0) : max_abs_error_{std::max(max_abs_error, 0.0)}, max_rel_error_{std::max(max_rel_error, 0.0)} {}
+    ~TableReducer() = default;
+
+    // Get tolerances
+    double max_abs_error() const { return max_abs_error_; }
+    double max_rel_error() const { return max_rel_error_; }
+
+    // Reduce a valid table, the methods and settings of the table are kept. An invalid table is returned as it is.
+    LookupTable1D Reduce(const LookupTable1D &table, ReductionReport &report) const;
+    LookupTable2D Reduce(const LookupTable2D &table, ReductionReport &report) const;
+
+    // Greedy selection of breakpoints, every column of values is one curve over the axis and tolerance gives the
+    // allowed error of every value. The first and last breakpoints are always kept.
+    std::vector<std::size_t> SelectBreakpoints(const Eigen::RowVectorXd &axis, const Eigen::MatrixXd &values, const Eigen::MatrixXd &tolerance) const;
+
+private:
+    double max_abs_error_ = 0;
+    double max_rel_error_ = 0;
+
+    // Allowed error of every value
+    Eigen::MatrixXd Tolerance(const Eigen::MatrixXd &values) const;
+
+    // Linear interpolation of the kept breakpoints at every original breakpoint, per column of values
+    Eigen::MatrixXd Resample(const Eigen::RowVectorXd &axis, const Eigen::MatrixXd &values, const std::vector<std::size_t> &kept) const;
+
+    // Add one compared point to the report
+    void AccumulateError(ReductionReport &report, const double &reference, const double &value) const;
+};
@@ -0,0 +1,230 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Named tables that can be replaced while other threads keep looking them up. A new table is validated by the
+// writer and published with one atomic pointer swap, readers never lock and always see a complete table.
+// Replaced tables are reclaimed by epoch: every reader announces the global epoch while it holds a table, and a
+// retired table is deleted once no reader announced an epoch older than its retirement.
+template <typename Table>
+class TableRegistry
+{
+public:
+    typedef LookupTable::AssignmentState AssignmentState;
+
+    // One published table, version grows with every publish of the slot
+    struct Version
+    {
+        Table table;
+        std::uint64_t version;
+    };
+    // A named slot, the pointer stays valid for the lifetime of the registry
+    struct Slot
+    {
+        std::string name;
+        std::atomic<Version *> current{nullptr};
+        std::uint64_t published = 0;
+    };
+    typedef const Slot *SlotHandle;
+
+    // Per-reader lookup state, the cursor is reset when the slot has been republished since the last lookup
+    struct SlotCursor
+    {
+        LookupTable::LookupCursor cursor;
+        std::uint64_t version = 0;
+    };
+
+    // Holds the current table of a slot for one reader, one guard per reader at a time
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const TableRegistry &registry, const std::size_t &reader, const SlotHandle &slot) : epoch_{registry.Enter(reader)}
+        {
+            version_ = (epoch_ != nullptr && slot != nullptr) ? slot->current.load(std::memory_order_seq_cst) : nullptr;
+        }
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+        ~ReadGuard()
+        {
+            if (epoch_ != nullptr)
+            {
+                epoch_->store(0, std::memory_order_release);
+            }
+        }
+
+        const Table *table() const { return version_ != nullptr ? &version_->table : nullptr; }
+        std::uint64_t version() const { return version_ != nullptr ? version_->version : 0; }
+
+    private:
+        std::atomic<std::uint64_t> *epoch_;
+        const Version *version_;
+    };
+
+    // Constructors and destructor, the reader count is fixed so the hot path never allocates
+    explicit TableRegistry(const std::size_t &max_readers = 64U) : max_readers_{max_readers}, readers_{new ReaderRecord[max_readers]} {}
+    TableRegistry(const TableRegistry &) = delete;
+    TableRegistry &operator=(const TableRegistry &) = delete;
+    ~TableRegistry()
+    {
+        for (auto &slot : slots_)
+        {
+            delete slot.current.load();
+        }
+        for (auto &retired : retired_)
+        {
+            delete retired.second;
+        }
+    }
+
+    // Readers, every thread that looks up tables claims its own reader index, max_readers() when all are taken
+    std::size_t max_readers() const { return max_readers_; }
+    std::size_t RegisterReader()
+    {
+        for (std::size_t reader = 0; reader != max_readers_; ++reader)
+        {
+            bool expected = false;
+            if (readers_[reader].claimed.compare_exchange_strong(expected, true))
+            {
+                return reader;
+            }
+        }
+        return max_readers_;
+    }
+    void UnregisterReader(const std::size_t &reader)
+    {
+        if (reader < max_readers_)
+        {
+            readers_[reader].epoch.store(0);
+            readers_[reader].claimed.store(false);
+        }
+    }
+
+    // Find a slot by name, nullptr if it was never published, resolve once and keep the handle for the hot path
+    SlotHandle Find(const std::string &name) const
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return FindSlot(name);
+    }
+
+    // Publish a table under a name, only valid tables replace the current one
+    AssignmentState Publish(const std::string &name, Table table)
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        Slot *slot = FindSlot(name);
+        if (!table.valid())
+        {
+            return (slot != nullptr && slot->current.load() != nullptr) ? AssignmentState::remain : AssignmentState::fail;
+        }
+        if (slot == nullptr)
+        {
+            slots_.emplace_back();
+            slot = &slots_.back();
+            slot->name = name;
+        }
+        Version *version = new Version{std::move(table), ++slot->published};
+        Version *previous = slot->current.exchange(version, std::memory_order_seq_cst);
+        if (previous != nullptr)
+        {
+            retired_.emplace_back(global_epoch_.fetch_add(1, std::memory_order_seq_cst), previous);
+        }
+        ReclaimRetired();
+        return AssignmentState::success;
+    }
+
+    // Delete the retired tables that no reader can hold any more, returns the number still waiting
+    std::size_t Reclaim()
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return ReclaimRetired();
+    }
+
+    // Lookup through a slot, values are the inputs of Table::Lookup, the last result is kept while the slot is empty
+    template <typename... Values>
+    double Lookup(const SlotHandle &slot, const std::size_t &reader, SlotCursor &cursor, const Values &...values) const
+    {
+        ReadGuard guard(*this, reader, slot);
+        const Table *table = guard.table();
+        if (table == nullptr)
+        {
+            return cursor.cursor.result;
+        }
+        if (guard.version() != cursor.version)
+        {
+            cursor.cursor.Reset(); // breakpoints may have changed, the next search starts from the configured method
+            cursor.version = guard.version();
+        }
+        return table->Lookup(values..., cursor.cursor);
+    }
+
+private:
+    struct alignas(64) ReaderRecord
+    {
+        std::atomic<std::uint64_t> epoch{0}; // 0 while the reader holds no table
+        std::atomic<bool> claimed{false};
+    };
+
+    const std::size_t max_readers_;
+    std::unique_ptr<ReaderRecord[]> readers_;
+    std::atomic<std::uint64_t> global_epoch_{1};
+    mutable std::mutex writer_mutex_;                         // serializes writers, readers never take it
+    std::deque<Slot> slots_;                                  // deque keeps slot addresses stable
+    std::vector<std::pair<std::uint64_t, Version *>> retired_; // epoch of retirement and the replaced table
+
+    // Announce the current epoch before the table pointer is loaded, nullptr for unknown readers
+    std::atomic<std::uint64_t> *Enter(const std::size_t &reader) const
+    {
+        if (reader >= max_readers_)
+        {
+            return nullptr;
+        }
+        std::atomic<std::uint64_t> &epoch = readers_[reader].epoch;
+        epoch.store(global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return &epoch;
+    }
+
+    Slot *FindSlot(const std::string &name) const
+    {
+        for (auto &slot : slots_)
+        {
+            if (slot.name == name)
+            {
+                return const_cast<Slot *>(&slot);
+            }
+        }
+        return nullptr;
+    }
+
+    std::size_t ReclaimRetired()
+    {
+        // A table retired at epoch e may still be held by readers that announced e or earlier
+        std::uint64_t oldest = global_epoch_.load(std::memory_order_seq_cst);
+        for (std::size_t reader = 0; reader != max_readers_; ++reader)
+        {
+            std::uint64_t epoch = readers_[reader].epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldest)
+            {
+                oldest = epoch;
+            }
+        }
+        auto first_kept = std::partition(retired_.begin(), retired_.end(), [oldest](const std::pair<std::uint64_t, Version *> &retired)
+                                         { return retired.first >= oldest; });
+        for (auto it = first_kept; it != retired_.end(); ++it)
+        {
+            delete it->second;
+        }
+        retired_.erase(first_kept, retired_.end());
+        return retired_.size();
+    }
+};
+
+typedef TableRegistry<LookupTable1D> TableRegistry1D;
+typedef TableRegistry<LookupTable2D> TableRegistry2D;
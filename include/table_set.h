@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "lookup_table.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+#include "lookup_table_view.h"
+
+// Many small tables packed into one arena. Tables are added in the order they are evaluated and Build copies all axes
+// and values back to back into a single 64-byte aligned allocation, so a pass over the set streams through memory
+// instead of visiting two or three heap blocks per table. Every table is served by a view into the arena and is
+// reached through a handle, an index with the generation of the set, which stays valid until Clear.
+// Views cannot evaluate the spline methods, so spline tables are not added, and 2D extrapolation is clip.
+class TableSet
+{
+public:
+    static constexpr std::size_t alignment_ = 64U;
+
+    struct Handle1D
+    {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0; // generation of the set that returned the handle
+        bool valid() const { return index != std::numeric_limits<std::uint32_t>::max(); }
+    };
+    struct Handle2D
+    {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+        bool valid() const { return index != std::numeric_limits<std::uint32_t>::max(); }
+    };
+
+    // Constructors and destructor, the views point into the arena so a set can be moved but not copied
+    TableSet() = default;
+    TableSet(const TableSet &) = delete;
+    TableSet &operator=(const TableSet &) = delete;
+    TableSet(TableSet &&) = default;
+    TableSet &operator=(TableSet &&) = default;
+    ~TableSet() = default;
+
+    // Get set state
+    bool built() const { return built_; }
+    std::size_t size() const { return tables_1d_.size() + tables_2d_.size(); }
+    std::size_t size_1d() const { return tables_1d_.size(); }
+    std::size_t size_2d() const { return tables_2d_.size(); }
+    std::size_t bytes() const { return arena_.size() * sizeof(double); } // arena size including the alignment padding
+    const double *data() const { return arena_.data() + arena_offset_; }
+
+    // Stage a copy of a valid table before Build, an invalid handle is returned for invalid tables, tables using a
+    // spline method on any axis, and after Build
+    Handle1D Add(const LookupTable1D &table);
+    Handle2D Add(const LookupTable2D &table);
+
+    // Pack every staged table into the arena in the order they were added and attach the views, the staging copies
+    // are released. Fails when nothing is staged or the set is already built.
+    bool Build();
+
+    // Release the arena and every table at once, the handles become invalid
+    void Clear();
+
+    // Views of the tables, usable after Build. Invalid handles and handles from before Clear get an empty view, also
+    // once new tables are added, since Clear starts a new generation.
+    LookupTable1DView &Table(const Handle1D &handle) { return Current(handle, tables_1d_.size()) ? tables_1d_[handle.index] : invalid_1d_; }
+    const LookupTable1DView &Table(const Handle1D &handle) const { return Current(handle, tables_1d_.size()) ? tables_1d_[handle.index] : invalid_1d_; }
+    LookupTable2DView &Table(const Handle2D &handle) { return Current(handle, tables_2d_.size()) ? tables_2d_[handle.index] : invalid_2d_; }
+    const LookupTable2DView &Table(const Handle2D &handle) const { return Current(handle, tables_2d_.size()) ? tables_2d_[handle.index] : invalid_2d_; }
+
+    // Lookup through a handle, the cursor forms keep the views unchanged. The empty view of an invalid handle returns
+    // 0, or the last result of the cursor.
+    double Lookup(const Handle1D &handle, const double &xvalue) { return Table(handle).Lookup(xvalue); }
+    double Lookup(const Handle1D &handle, const double &xvalue, LookupTable::LookupCursor &cursor) const { return Table(handle).Lookup(xvalue, cursor); }
+    double Lookup(const Handle2D &handle, const double &rvalue, const double &cvalue) { return Table(handle).Lookup(rvalue, cvalue); }
+    double Lookup(const Handle2D &handle, const double &rvalue, const double &cvalue, LookupTable::LookupCursor &cursor) const
+    {
+        return Table(handle).Lookup(rvalue, cvalue, cursor);
+    }
+
+private:
+    // Staged table, the values are kept in the layout they will have in the arena
+    struct TableRecord
+    {
+        std::uint8_t dimensions = 1;
+        std::uint32_t index = 0; // index into tables_1d_ or tables_2d_
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+        std::vector<double> data; // axes followed by the values, 2D maps column by column
+        LookupTable::SearchMethod search_method = LookupTable::SearchMethod::bin;
+        LookupTable::InterpMethod interp_method = LookupTable::InterpMethod::linear;     // row method of 2D tables
+        LookupTable::InterpMethod col_interp_method = LookupTable::InterpMethod::linear; // 2D only
+        LookupTable::ExtrapMethod extrap_method = LookupTable::ExtrapMethod::clip;
+        double lower_value = 0;
+        double upper_value = 0;
+    };
+
+    bool built_ = false;
+    std::uint32_t generation_ = 0; // incremented by Clear
+    std::vector<TableRecord> records_;
+    std::vector<double> arena_; // padded in front for the alignment
+    std::size_t arena_offset_ = 0;
+    std::vector<LookupTable1DView> tables_1d_;
+    std::vector<LookupTable2DView> tables_2d_;
+    LookupTable1DView invalid_1d_; // never attached
+    LookupTable2DView invalid_2d_;
+
+    // Interp methods the views evaluate like the tables
+    static bool isViewMethod(const LookupTable::InterpMethod &method);
+
+    // True for a handle of the current generation that indexes a table
+    template <typename Handle>
+    bool Current(const Handle &handle, const std::size_t &size) const { return handle.index < size && handle.generation == generation_; }
+
+    // Add the record of a table, staged while the set is not built and the index fits the handle
+    bool Stage(TableRecord &&record);
+};
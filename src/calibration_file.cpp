@@ -0,0 +1,385 @@
+#include "calibration_file.h"
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CALIBRATION_FILE_MMAP 1
+#endif
+
+constexpr std::uint32_t CalibrationFile::version_;
+constexpr std::size_t CalibrationFile::alignment_;
+constexpr std::size_t CalibrationFile::max_name_size_;
+
+namespace
+{
+    const char file_magic[8] = {'L', 'U', 'T', 'C', 'A', 'L', 'I', 'B'};
+    const std::uint32_t byte_order_mark = 0x01020304U;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t table_count;
+        std::uint64_t directory_offset;
+        std::uint64_t file_size;
+        std::uint64_t checksum; // over everything after the header
+        std::uint64_t reserved[2];
+    };
+    static_assert(sizeof(FileHeader) == 64, "header must fill one alignment block");
+
+    std::size_t AlignOffset(const std::size_t &offset)
+    {
+        return (offset + CalibrationFile::alignment_ - 1) / CalibrationFile::alignment_ * CalibrationFile::alignment_;
+    }
+
+    // FNV-1a on 64-bit words, the file size is always a multiple of the alignment
+    std::uint64_t Checksum(const unsigned char *data, const std::size_t &size)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (std::size_t offset = 0; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + offset, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+struct CalibrationFile::DirectoryEntry
+{
+    char name[max_name_size_ + 1];
+    std::uint32_t dimensions;
+    std::uint32_t interp_method;
+    std::uint32_t extrap_method;
+    std::uint32_t reserved0;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t row_axis_offset;
+    std::uint64_t col_axis_offset;
+    std::uint64_t data_offset;
+    double lower_value;
+    double upper_value;
+    std::uint32_t row_uniform;
+    std::uint32_t col_uniform;
+    double row_origin;
+    double row_inverse_step;
+    double col_origin;
+    double col_inverse_step;
+    std::uint64_t reserved1[2];
+};
+
+// Loader
+CalibrationFile::FileState CalibrationFile::Open(const std::string &path, const bool &verify_checksum)
+{
+    static_assert(sizeof(DirectoryEntry) % alignment_ == 0, "directory entries keep the data aligned");
+    Close();
+#ifdef CALIBRATION_FILE_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        return file_state_ = FileState::open_failed;
+    }
+    struct stat file_stat;
+    if (::fstat(descriptor, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(FileHeader)))
+    {
+        ::close(descriptor);
+        return file_state_ = FileState::open_failed;
+    }
+    void *mapping = ::mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // the mapping stays valid after the descriptor is closed
+    if (mapping == MAP_FAILED)
+    {
+        return file_state_ = FileState::open_failed;
+    }
+    file_data_ = static_cast<const unsigned char *>(mapping);
+    file_size_ = static_cast<std::size_t>(file_stat.st_size);
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream || stream.tellg() < static_cast<std::streamoff>(sizeof(FileHeader)))
+    {
+        return file_state_ = FileState::open_failed;
+    }
+    file_size_ = static_cast<std::size_t>(stream.tellg());
+    file_buffer_.resize((file_size_ + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char *>(file_buffer_.data()), file_size_);
+    file_data_ = reinterpret_cast<const unsigned char *>(file_buffer_.data());
+#endif
+
+    FileHeader header;
+    std::memcpy(&header, file_data_, sizeof(header));
+    if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 || header.byte_order != byte_order_mark || header.file_size != file_size_)
+    {
+        Close();
+        return file_state_ = FileState::format_invalid;
+    }
+    else if (header.version != version_)
+    {
+        Close();
+        return file_state_ = FileState::version_not_match;
+    }
+    else if (header.directory_offset > file_size_ || header.directory_offset % alignment_ != 0 || header.table_count > (file_size_ - header.directory_offset) / sizeof(DirectoryEntry))
+    {
+        Close();
+        return file_state_ = FileState::format_invalid;
+    }
+    else if (verify_checksum && Checksum(file_data_ + sizeof(FileHeader), file_size_ - sizeof(FileHeader)) != header.checksum)
+    {
+        Close();
+        return file_state_ = FileState::checksum_not_match;
+    }
+    table_count_ = static_cast<std::size_t>(header.table_count);
+    directory_ = reinterpret_cast<const DirectoryEntry *>(file_data_ + header.directory_offset);
+    return file_state_ = FileState::valid;
+}
+
+void CalibrationFile::Close()
+{
+#ifdef CALIBRATION_FILE_MMAP
+    if (file_data_ != nullptr)
+    {
+        ::munmap(const_cast<unsigned char *>(file_data_), file_size_);
+    }
+#endif
+    file_buffer_.clear();
+    file_data_ = nullptr;
+    file_size_ = 0;
+    table_count_ = 0;
+    directory_ = nullptr;
+    file_state_ = FileState::empty;
+}
+
+const CalibrationFile::DirectoryEntry *CalibrationFile::Find(const std::string &name) const
+{
+    if (!valid() || name.size() > max_name_size_)
+    {
+        return nullptr;
+    }
+    // The directory is sorted by name, the search cost grows with log of the table count
+    const DirectoryEntry *end = directory_ + table_count_;
+    const DirectoryEntry *entry = std::lower_bound(directory_, end, name, [](const DirectoryEntry &lhs, const std::string &rhs)
+                                                   { return std::strncmp(lhs.name, rhs.c_str(), sizeof(lhs.name)) < 0; });
+    return (entry != end && std::strncmp(entry->name, name.c_str(), sizeof(entry->name)) == 0) ? entry : nullptr;
+}
+
+const double *CalibrationFile::Array(const std::uint64_t &offset, const std::uint64_t &count) const
+{
+    if (offset % alignment_ != 0 || offset > file_size_ || count > (file_size_ - offset) / sizeof(double))
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const double *>(file_data_ + offset);
+}
+
+bool CalibrationFile::Contains(const std::string &name) const
+{
+    return Find(name) != nullptr;
+}
+
+std::vector<std::string> CalibrationFile::Names() const
+{
+    std::vector<std::string> names;
+    if (!valid())
+    {
+        return names;
+    }
+    names.reserve(table_count_);
+    for (std::size_t index = 0; index != table_count_; ++index)
+    {
+        const char *name = directory_[index].name;
+        names.emplace_back(name, std::find(name, name + max_name_size_, '\0'));
+    }
+    return names;
+}
+
+LookupTable1DView CalibrationFile::Table1D(const std::string &name) const
+{
+    LookupTable1DView view;
+    const DirectoryEntry *entry = Find(name);
+    if (entry == nullptr || entry->dimensions != 1 || entry->rows < 2)
+    {
+        return view;
+    }
+    const double *x_axis = Array(entry->row_axis_offset, entry->rows);
+    const double *y_table = Array(entry->data_offset, entry->rows);
+    if (x_axis == nullptr || y_table == nullptr)
+    {
+        return view;
+    }
+    LookupTable::AxisAccelerator x_accelerator;
+    x_accelerator.uniform = entry->row_uniform != 0;
+    x_accelerator.origin = entry->row_origin;
+    x_accelerator.inverse_step = entry->row_inverse_step;
+    view.Attach(x_axis, y_table, static_cast<std::size_t>(entry->rows), x_accelerator);
+    view.SetInterpMethod(static_cast<LookupTable::InterpMethod>(entry->interp_method));
+    view.SetExtrapMethod(static_cast<LookupTable::ExtrapMethod>(entry->extrap_method), entry->lower_value, entry->upper_value);
+    return view;
+}
+
+LookupTable2DView CalibrationFile::Table2D(const std::string &name) const
+{
+    LookupTable2DView view;
+    const DirectoryEntry *entry = Find(name);
+    if (entry == nullptr || entry->dimensions != 2 || entry->rows < 2 || entry->cols < 2)
+    {
+        return view;
+    }
+    const double *row_axis = Array(entry->row_axis_offset, entry->rows);
+    const double *col_axis = Array(entry->col_axis_offset, entry->cols);
+    const double *map_data = entry->rows <= file_size_ / entry->cols ? Array(entry->data_offset, entry->rows * entry->cols) : nullptr;
+    if (row_axis == nullptr || col_axis == nullptr || map_data == nullptr)
+    {
+        return view;
+    }
+    LookupTable::AxisAccelerator row_accelerator;
+    row_accelerator.uniform = entry->row_uniform != 0;
+    row_accelerator.origin = entry->row_origin;
+    row_accelerator.inverse_step = entry->row_inverse_step;
+    LookupTable::AxisAccelerator col_accelerator;
+    col_accelerator.uniform = entry->col_uniform != 0;
+    col_accelerator.origin = entry->col_origin;
+    col_accelerator.inverse_step = entry->col_inverse_step;
+    view.Attach(row_axis, col_axis, map_data, static_cast<std::size_t>(entry->rows), static_cast<std::size_t>(entry->cols), row_accelerator, col_accelerator);
+    view.SetInterpMethod(static_cast<LookupTable::InterpMethod>(entry->interp_method));
+    return view;
+}
+
+// Writer
+bool CalibrationFileWriter::AcceptName(const std::string &name) const
+{
+    if (name.empty() || name.size() > CalibrationFile::max_name_size_ || name.find('\0') != std::string::npos)
+    {
+        return false;
+    }
+    return std::none_of(tables_.begin(), tables_.end(), [&name](const TableRecord &record)
+                        { return record.name == name; });
+}
+
+bool CalibrationFileWriter::AddTable(const std::string &name, const LookupTable1D &table)
+{
+    if (!table.valid() || !AcceptName(name))
+    {
+        return false;
+    }
+    TableRecord record;
+    record.name = name;
+    record.rows = table.size();
+    record.row_axis.assign(table.x_axis().data(), table.x_axis().data() + table.size());
+    record.data.assign(table.y_table().data(), table.y_table().data() + table.size());
+    record.interp_method = table.interp_method();
+    record.extrap_method = table.extrap_method();
+    record.lower_value = table.lower_extrap_value();
+    record.upper_value = table.upper_extrap_value();
+    LookupTable1DView view(record.row_axis.data(), record.data.data(), record.rows); // validates again and builds the accelerator
+    view.SetInterpMethod(table.interp_method());                                     // spline curves cannot be read back as views
+    if (!view.valid())
+    {
+        return false;
+    }
+    record.row_accelerator = view.x_accelerator_;
+    tables_.push_back(std::move(record));
+    return true;
+}
+
+bool CalibrationFileWriter::AddTable(const std::string &name, const LookupTable2D &table)
+{
+    if (!table.valid() || !AcceptName(name))
+    {
+        return false;
+    }
+    TableRecord record;
+    record.name = name;
+    record.rows = table.rows();
+    record.cols = table.cols();
+    record.row_axis.assign(table.row_axis().data(), table.row_axis().data() + table.rows());
+    record.col_axis.assign(table.col_axis().data(), table.col_axis().data() + table.cols());
+    record.data.resize(record.rows * record.cols);
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(record.data.data(), record.rows, record.cols) = table.map_matrix();
+    record.interp_method = table.interp_method();
+    record.extrap_method = table.extrap_method();
+    LookupTable2DView view(record.row_axis.data(), record.col_axis.data(), record.data.data(), record.rows, record.cols);
+    view.SetInterpMethod(table.row_interp_method(), table.col_interp_method()); // spline maps cannot be read back as views
+    if (!view.valid())
+    {
+        return false;
+    }
+    record.row_accelerator = view.row_accelerator_;
+    record.col_accelerator = view.col_accelerator_;
+    tables_.push_back(std::move(record));
+    return true;
+}
+
+bool CalibrationFileWriter::Write(const std::string &path) const
+{
+    typedef CalibrationFile::DirectoryEntry DirectoryEntry;
+
+    // Directory order is by name, the data follows in the same order
+    std::vector<const TableRecord *> order;
+    for (const auto &record : tables_)
+    {
+        order.push_back(&record);
+    }
+    std::sort(order.begin(), order.end(), [](const TableRecord *lhs, const TableRecord *rhs)
+              { return std::strncmp(lhs->name.c_str(), rhs->name.c_str(), CalibrationFile::max_name_size_ + 1) < 0; });
+
+    std::vector<DirectoryEntry> directory(order.size());
+    std::size_t offset = sizeof(FileHeader) + directory.size() * sizeof(DirectoryEntry);
+    for (std::size_t i = 0; i != order.size(); ++i)
+    {
+        const TableRecord &record = *order[i];
+        DirectoryEntry &entry = directory[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, record.name.c_str(), record.name.size());
+        entry.dimensions = record.cols == 0 ? 1U : 2U;
+        entry.interp_method = static_cast<std::uint32_t>(record.interp_method);
+        entry.extrap_method = static_cast<std::uint32_t>(record.extrap_method);
+        entry.rows = record.rows;
+        entry.cols = record.cols;
+        entry.lower_value = record.lower_value;
+        entry.upper_value = record.upper_value;
+        entry.row_uniform = record.row_accelerator.uniform ? 1U : 0U;
+        entry.row_origin = record.row_accelerator.origin;
+        entry.row_inverse_step = record.row_accelerator.inverse_step;
+        entry.col_uniform = record.col_accelerator.uniform ? 1U : 0U;
+        entry.col_origin = record.col_accelerator.origin;
+        entry.col_inverse_step = record.col_accelerator.inverse_step;
+        entry.row_axis_offset = AlignOffset(offset);
+        offset = entry.row_axis_offset + record.row_axis.size() * sizeof(double);
+        entry.col_axis_offset = AlignOffset(offset);
+        offset = entry.col_axis_offset + record.col_axis.size() * sizeof(double);
+        entry.data_offset = AlignOffset(offset);
+        offset = entry.data_offset + record.data.size() * sizeof(double);
+    }
+    const std::size_t file_size = AlignOffset(offset);
+
+    std::vector<unsigned char> buffer(file_size, 0);
+    std::memcpy(buffer.data() + sizeof(FileHeader), directory.data(), directory.size() * sizeof(DirectoryEntry));
+    for (std::size_t i = 0; i != order.size(); ++i)
+    {
+        const TableRecord &record = *order[i];
+        std::copy(record.row_axis.begin(), record.row_axis.end(), reinterpret_cast<double *>(buffer.data() + directory[i].row_axis_offset));
+        std::copy(record.col_axis.begin(), record.col_axis.end(), reinterpret_cast<double *>(buffer.data() + directory[i].col_axis_offset));
+        std::copy(record.data.begin(), record.data.end(), reinterpret_cast<double *>(buffer.data() + directory[i].data_offset));
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = CalibrationFile::version_;
+    header.byte_order = byte_order_mark;
+    header.table_count = directory.size();
+    header.directory_offset = sizeof(FileHeader);
+    header.file_size = file_size;
+    header.checksum = Checksum(buffer.data() + sizeof(FileHeader), file_size - sizeof(FileHeader));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(stream);
+}
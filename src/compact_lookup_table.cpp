@@ -0,0 +1,261 @@
+#include "compact_lookup_table.h"
+
+template <typename Storage>
+void CompactLookupTable::Quantize(const double *values, const std::size_t &count, Storage *stored)
+{
+    if (!std::numeric_limits<Storage>::is_integer)
+    {
+        scale_ = 1;
+        offset_ = 0;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            stored[i] = static_cast<Storage>(values[i]);
+        }
+        return;
+    }
+
+    // Symmetric fixed point range centred on the data, so both ends of the data use the full integer range
+    const double min_value = *std::min_element(values, values + count);
+    const double max_value = *std::max_element(values, values + count);
+    const double limit = static_cast<double>(std::numeric_limits<Storage>::max());
+    offset_ = 0.5 * (min_value + max_value);
+    scale_ = (max_value - min_value) > 0 ? 0.5 * (max_value - min_value) / limit : 1.0;
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        double quantized = std::round((values[i] - offset_) / scale_);
+        stored[i] = static_cast<Storage>(std::min(std::max(quantized, -limit), limit));
+    }
+}
+
+void CompactLookupTable::AccumulateError(QuantizationReport &report, const double &reference, const double &value, double &square_sum) const
+{
+    const double error = std::abs(value - reference);
+    report.max_abs_error = std::max(report.max_abs_error, error);
+    report.max_rel_error = std::max(report.max_rel_error, error / std::max(std::abs(reference), epsilon_));
+    square_sum += error * error;
+    ++report.samples;
+}
+void CompactLookupTable::FinishReport(QuantizationReport &report, const double &square_sum) const
+{
+    report.rms_error = report.samples > 0 ? std::sqrt(square_sum / report.samples) : 0.0;
+}
+
+// One-dimensional compact table
+template <typename Storage>
+LookupTable::AssignmentState CompactLookupTable1D<Storage>::AssignTableData(const LookupTable1D &reference)
+{
+    if (!reference.valid())
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    x_axis_ = reference.x_axis();
+    y_table_.resize(reference.y_table().size());
+    Quantize(reference.y_table().data(), reference.size(), y_table_.data());
+    table_size_ = reference.size();
+    search_method_ = reference.search_method();
+    interp_method_ = reference.interp_method();
+    extrap_method_ = reference.extrap_method();
+    lower_extrap_value_specify_ = reference.lower_extrap_value();
+    upper_extrap_value_specify_ = reference.upper_extrap_value();
+    x_accelerator_ = BuildAxisAccelerator(x_axis_);
+    prelook_index_ = 0;
+    table_valid_ = true;
+    table_empty_ = false;
+    table_state_ = TableState::valid;
+    return AssignmentState::success;
+}
+template <typename Storage>
+bool CompactLookupTable1D<Storage>::ClearTable()
+{
+    x_axis_.resize(0);
+    y_table_.resize(0);
+    table_size_ = 0;
+    x_accelerator_ = AxisAccelerator();
+    table_valid_ = false;
+    table_empty_ = true;
+    table_state_ = TableState::empty;
+    return true;
+}
+
+template <typename Storage>
+double CompactLookupTable1D<Storage>::Evaluate(const std::size_t &index, const double &xvalue, const double &fallback) const
+{
+    double result = fallback;
+    EvaluateSegment(index, table_size_, xvalue, x_axis_.data(), [this](const std::size_t &i) { return Value(i); }, lower_extrap_value_specify_, upper_extrap_value_specify_, result);
+    return result;
+}
+
+template <typename Storage>
+double CompactLookupTable1D<Storage>::Lookup(const double &xvalue)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        prelook_index_ = SearchAxis(xvalue, x_axis_, x_accelerator_, search_method_, prelook_index_);
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        lookup_result_ = Evaluate(prelook_index_, xvalue, lookup_result_);
+    }
+    return lookup_result_;
+}
+template <typename Storage>
+double CompactLookupTable1D<Storage>::Lookup(const double &xvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        cursor.row_index = SearchAxis(xvalue, x_axis_, x_accelerator_, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index);
+        cursor.primed = true;
+        cursor.result = Evaluate(cursor.row_index, xvalue, cursor.result);
+    }
+    return cursor.result;
+}
+
+template <typename Storage>
+typename CompactLookupTable::QuantizationReport CompactLookupTable1D<Storage>::AccuracyReport(const LookupTable1D &reference) const
+{
+    QuantizationReport report;
+    report.reference_bytes = reference.size() * 2 * sizeof(double);
+    report.compact_bytes = memory_bytes();
+    if (!table_valid_ || !reference.valid() || reference.size() != table_size_)
+    {
+        return report;
+    }
+    // Spline references are compared as linear, the compact table evaluates them as linear and only the
+    // quantization error is reported
+    LookupTable1D compared(reference);
+    if (isSplineMethod(compared.interp_method()))
+    {
+        compared.SetInterpMethod(InterpMethod::linear);
+    }
+    double square_sum = 0;
+    LookupCursor reference_cursor;
+    LookupCursor compact_cursor;
+    for (std::size_t i = 0; i != table_size_; ++i)
+    {
+        const double xvalue = x_axis_(i);
+        AccumulateError(report, compared.Lookup(xvalue, reference_cursor), Lookup(xvalue, compact_cursor), square_sum);
+        if (i + 1 != table_size_)
+        {
+            const double midpoint = 0.5 * (x_axis_(i) + x_axis_(i + 1));
+            AccumulateError(report, compared.Lookup(midpoint, reference_cursor), Lookup(midpoint, compact_cursor), square_sum);
+        }
+    }
+    FinishReport(report, square_sum);
+    return report;
+}
+
+// Two-dimensional compact table
+template <typename Storage>
+LookupTable::AssignmentState CompactLookupTable2D<Storage>::AssignTableData(const LookupTable2D &reference)
+{
+    if (!reference.valid())
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    row_axis_ = reference.row_axis();
+    col_axis_ = reference.col_axis();
+    map_matrix_.resize(reference.map_matrix().rows(), reference.map_matrix().cols());
+    Quantize(reference.map_matrix().data(), reference.rows() * reference.cols(), map_matrix_.data());
+    table_size_ = reference.size();
+    search_method_ = reference.search_method();
+    interp_method_ = reference.interp_method();
+    extrap_method_ = reference.extrap_method();
+    row_accelerator_ = BuildAxisAccelerator(row_axis_);
+    col_accelerator_ = BuildAxisAccelerator(col_axis_);
+    prelook_index_ = {0, 0};
+    table_valid_ = true;
+    table_empty_ = false;
+    table_state_ = TableState::valid;
+    return AssignmentState::success;
+}
+template <typename Storage>
+bool CompactLookupTable2D<Storage>::ClearTable()
+{
+    row_axis_.resize(0);
+    col_axis_.resize(0);
+    map_matrix_.resize(0, 0);
+    table_size_ = {0, 0};
+    row_accelerator_ = AxisAccelerator();
+    col_accelerator_ = AxisAccelerator();
+    table_valid_ = false;
+    table_empty_ = true;
+    table_state_ = TableState::empty;
+    return true;
+}
+
+template <typename Storage>
+double CompactLookupTable2D<Storage>::Evaluate(const std::size_t &rindex, const std::size_t &cindex, const double &rvalue, const double &cvalue) const
+{
+    return EvaluateCell(rindex, cindex, table_size_.rows(), table_size_.cols(), rvalue, cvalue, row_axis_.data(), col_axis_.data(),
+                        [this](const std::size_t &row, const std::size_t &col) { return Value(row, col); });
+}
+
+template <typename Storage>
+double CompactLookupTable2D<Storage>::Lookup(const double &rvalue, const double &cvalue)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        std::size_t row = SearchAxis(rvalue, row_axis_, row_accelerator_, search_method_, prelook_index_.rows());
+        std::size_t col = SearchAxis(cvalue, col_axis_, col_accelerator_, search_method_, prelook_index_.cols());
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        prelook_index_ = {row, col};
+        lookup_result_ = Evaluate(row, col, rvalue, cvalue);
+    }
+    return lookup_result_;
+}
+template <typename Storage>
+double CompactLookupTable2D<Storage>::Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        SearchMethod method = cursor.primed ? NextSearchMethod(search_method_) : search_method_;
+        cursor.row_index = SearchAxis(rvalue, row_axis_, row_accelerator_, method, cursor.row_index);
+        cursor.col_index = SearchAxis(cvalue, col_axis_, col_accelerator_, method, cursor.col_index);
+        cursor.primed = true;
+        cursor.result = Evaluate(cursor.row_index, cursor.col_index, rvalue, cvalue);
+    }
+    return cursor.result;
+}
+
+template <typename Storage>
+typename CompactLookupTable::QuantizationReport CompactLookupTable2D<Storage>::AccuracyReport(const LookupTable2D &reference) const
+{
+    QuantizationReport report;
+    report.reference_bytes = (reference.rows() + reference.cols() + reference.rows() * reference.cols()) * sizeof(double);
+    report.compact_bytes = memory_bytes();
+    if (!table_valid_ || !reference.valid() || reference.size() != table_size_)
+    {
+        return report;
+    }
+    // Spline references are compared as linear, like the 1D report
+    LookupTable2D compared(reference);
+    if (isSplineMethod(compared.row_interp_method()) || isSplineMethod(compared.col_interp_method()))
+    {
+        compared.SetInterpMethod(InterpMethod::linear);
+    }
+    // Breakpoints, midpoints of the segments and centres of the cells
+    double square_sum = 0;
+    LookupCursor reference_cursor;
+    LookupCursor compact_cursor;
+    for (std::size_t i = 0; i != 2 * table_size_.rows() - 1; ++i)
+    {
+        const double rvalue = (i % 2 == 0) ? row_axis_(i / 2) : 0.5 * (row_axis_(i / 2) + row_axis_(i / 2 + 1));
+        for (std::size_t j = 0; j != 2 * table_size_.cols() - 1; ++j)
+        {
+            const double cvalue = (j % 2 == 0) ? col_axis_(j / 2) : 0.5 * (col_axis_(j / 2) + col_axis_(j / 2 + 1));
+            AccumulateError(report, compared.Lookup(rvalue, cvalue, reference_cursor), Lookup(rvalue, cvalue, compact_cursor), square_sum);
+        }
+    }
+    FinishReport(report, square_sum);
+    return report;
+}
+
+// Supported storage types
+template class CompactLookupTable1D<float>;
+template class CompactLookupTable1D<std::int16_t>;
+template class CompactLookupTable1D<std::int32_t>;
+template class CompactLookupTable2D<float>;
+template class CompactLookupTable2D<std::int16_t>;
+template class CompactLookupTable2D<std::int32_t>;
@@ -0,0 +1,84 @@
+#include "lookup_statistics.h"
+
+constexpr std::size_t LookupStatisticsSnapshot::histogram_size_;
+constexpr std::uint64_t LookupStatistics::sample_period_;
+
+void LookupStatisticsSnapshot::WriteCsvHeader(std::ostream &output)
+{
+    output << "table,lookups,scalar_lookups,searches,interpolations,below,above,extrap_clip,extrap_linear,extrap_specify,walks,mean_walk,fallbacks,samples,mean_latency_ns,estimated_ns";
+    for (std::size_t bucket = 0; bucket != histogram_size_; ++bucket)
+    {
+        output << ",latency_" << (std::uint64_t(1) << bucket) << "ns";
+    }
+    output << "\n";
+}
+
+void LookupStatisticsSnapshot::WriteCsv(std::ostream &output, const std::string &name) const
+{
+    output << name << "," << lookups << "," << scalar_lookups << "," << searches << "," << interpolations << "," << below << "," << above << ","
+           << extrapolations[0] << "," << extrapolations[1] << "," << extrapolations[2] << "," << walks << "," << mean_walk() << ","
+           << fallbacks << "," << samples << "," << mean_latency_ns() << "," << estimated_ns();
+    for (const auto &count : latency_histogram)
+    {
+        output << "," << count;
+    }
+    output << "\n";
+}
+
+void LookupStatistics::RecordLatency(const std::int64_t &ns)
+{
+    // Bucket of the highest set bit, everything above the last bucket goes to it
+    std::size_t bucket = 0;
+    for (std::uint64_t value = ns > 0 ? static_cast<std::uint64_t>(ns) : 0; value > 1 && bucket + 1 < latency_histogram_.size(); value >>= 1)
+    {
+        ++bucket;
+    }
+    samples_.Add(1);
+    sampled_ns_.Add(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+    latency_histogram_[bucket].Add(1);
+}
+
+LookupStatisticsSnapshot LookupStatistics::Snapshot() const
+{
+    LookupStatisticsSnapshot snapshot;
+    snapshot.enabled = true;
+    snapshot.lookups = lookups_.Load();
+    snapshot.scalar_lookups = scalar_lookups_.Load();
+    snapshot.searches = searches_.Load();
+    snapshot.interpolations = interpolations_.Load();
+    snapshot.below = below_.Load();
+    snapshot.above = above_.Load();
+    for (std::size_t method = 0; method != extrapolations_.size(); ++method)
+    {
+        snapshot.extrapolations[method] = extrapolations_[method].Load();
+    }
+    snapshot.walks = walks_.Load();
+    snapshot.walk_distance = walk_distance_.Load();
+    snapshot.fallbacks = fallbacks_.Load();
+    snapshot.samples = samples_.Load();
+    snapshot.sampled_ns = sampled_ns_.Load();
+    for (std::size_t bucket = 0; bucket != latency_histogram_.size(); ++bucket)
+    {
+        snapshot.latency_histogram[bucket] = latency_histogram_[bucket].Load();
+    }
+    return snapshot;
+}
+
+void LookupStatistics::CopyFrom(const LookupStatistics &other)
+{
+    const Counter *source[] = {&other.lookups_, &other.scalar_lookups_, &other.searches_, &other.interpolations_, &other.below_, &other.above_, &other.walks_,
+                               &other.walk_distance_, &other.fallbacks_, &other.samples_, &other.sampled_ns_};
+    Counter *target[] = {&lookups_, &scalar_lookups_, &searches_, &interpolations_, &below_, &above_, &walks_, &walk_distance_, &fallbacks_, &samples_, &sampled_ns_};
+    for (std::size_t index = 0; index != sizeof(source) / sizeof(source[0]); ++index)
+    {
+        target[index]->value.store(source[index]->Load(), std::memory_order_relaxed);
+    }
+    for (std::size_t method = 0; method != extrapolations_.size(); ++method)
+    {
+        extrapolations_[method].value.store(other.extrapolations_[method].Load(), std::memory_order_relaxed);
+    }
+    for (std::size_t bucket = 0; bucket != latency_histogram_.size(); ++bucket)
+    {
+        latency_histogram_[bucket].value.store(other.latency_histogram_[bucket].Load(), std::memory_order_relaxed);
+    }
+}
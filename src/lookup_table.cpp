@@ -1,100 +1,465 @@
 #include "lookup_table.h"
 
-std::size_t LookupTable::SearchIndex(const double &value, const Eigen::RowVectorXd &table, const SearchMethod &method, const std::size_t &last_index)
+constexpr std::size_t LookupTable::batch_block_size_;
+constexpr std::size_t LookupTable::axis_index_min_size_;
+constexpr std::size_t LookupTable::near_window_;
+constexpr std::size_t LookupTable::EytzingerIndex::block_size;
+
+namespace
+{
+    // Fill the Eytzinger layout by an in-order walk of the implicit tree, so the block keys come out sorted
+    void FillEytzinger(const Eigen::Ref<const Eigen::RowVectorXd> &axis, double *keys, std::uint32_t *positions, const std::size_t &size, const std::size_t &node, std::size_t &next)
+    {
+        if (node <= size)
+        {
+            const std::size_t block_size = LookupTable::EytzingerIndex::block_size;
+            FillEytzinger(axis, keys, positions, size, 2 * node, next);
+            keys[node] = axis(std::min((next + 1) * block_size, static_cast<std::size_t>(axis.size())) - 1);
+            positions[node] = static_cast<std::uint32_t>(next);
+            ++next;
+            FillEytzinger(axis, keys, positions, size, 2 * node + 1, next);
+        }
+    }
+}
+
+std::size_t LookupTable::SearchIndex(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const SearchMethod &method, const std::size_t &last_index) const
 {
     switch (method)
     {
     case SearchMethod::seq:
+        return SearchSequential(value, table);
+    case SearchMethod::bin:
+        return SearchBinary(value, table);
+    case SearchMethod::near:
+        return SearchNear(value, table, last_index);
+    case SearchMethod::adaptive:
+        return SearchGallop(value, table, last_index);
+    default:
+        return last_index;
+    }
+}
+
+std::size_t LookupTable::SearchSequential(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table) const
+{
+    std::size_t index = 0;
+    for (index = 0; index != table.size(); ++index)
     {
-        std::size_t index = 0;
-        for (index = 0; index != table.size(); ++index)
+        if (value <= table(index))
         {
-            if (value <= table(index))
-            {
-                break;
-            }
+            break;
         }
-        return index;
     }
-    case SearchMethod::bin:
+    return index;
+}
+
+std::size_t LookupTable::SearchBinary(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table) const
+{
+    // Edge cases: value is out of bound
+    if (value <= table(0))
+    {
+        return 0;
+    }
+    else if (value >= table(table.size() - 1))
+    {
+        return table.size();
+    }
+
+    std::size_t left = 0;
+    std::size_t right = table.size() - 1;
+
+    while (left < right)
     {
-        // Edge cases: value is out of bound
+        std::size_t mid = left + (right - left) / 2; // Avoid overflow with safer midpoint calculation
 
-        if (value <= table(0))
+        if (value <= table(mid))
         {
-            return 0;
+            right = mid; // Narrow down to the left half
         }
-        else if (value >= table(table.size() - 1))
+        else
         {
-            return table.size();
+            left = mid + 1; // Narrow down to the right half
         }
+    }
+    return left;
+}
+
+std::size_t LookupTable::SearchNear(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const std::size_t &last_index) const
+{
+    // Edge cases and NaN input follow the binary search
+    const std::size_t size = table.size();
+    if (value <= table(0))
+    {
+        return 0;
+    }
+    else if (value >= table(size - 1))
+    {
+        return size;
+    }
+    else if (value != value)
+    {
+        return SearchBinary(value, table);
+    }
 
-        std::size_t left = 0;
-        std::size_t right = table.size() - 1;
+    // Start from the last known index clamped to the inner segments, then walk until table(index - 1) < value <= table(index).
+    // A value on a breakpoint ends on the segment below it from either direction, the same index as the binary search.
+    std::size_t index = std::min(std::max(last_index, std::size_t(1)), size - 1);
+    while (value > table(index))
+    {
+        ++index; // Forward search
+    }
+    while (value <= table(index - 1))
+    {
+        --index; // Backward search
+    }
+    return index;
+}
+
+std::size_t LookupTable::SearchUniform(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator) const
+{
+    // Edge cases and NaN input follow the binary search
+    const std::size_t size = table.size();
+    if (value <= table(0))
+    {
+        return 0;
+    }
+    else if (value >= table(size - 1))
+    {
+        return size;
+    }
+    else if (value != value)
+    {
+        return SearchBinary(value, table);
+    }
+
+    // Direct index from the step, then clamp to the inner segments
+    double position = (value - accelerator.origin) * accelerator.inverse_step;
+    std::size_t index = static_cast<std::size_t>(std::floor(std::max(position, 0.0))) + 1;
+    index = std::min(index, size - 1);
+
+    // Rounding can move the index by one next to a breakpoint, correct against the axis to match the binary search
+    while (index > 1 && value <= table(index - 1))
+    {
+        --index;
+    }
+    while (index < size - 1 && value > table(index))
+    {
+        ++index;
+    }
+    return index;
+}
+
+std::size_t LookupTable::SearchEytzinger(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator) const
+{
+    // Edge cases and NaN input follow the binary search
+    const std::size_t size = table.size();
+    if (value <= table(0))
+    {
+        return 0;
+    }
+    else if (value >= table(size - 1))
+    {
+        return size;
+    }
+    else if (value != value)
+    {
+        return SearchBinary(value, table);
+    }
+
+    // Branchless descent, the comparison picks the child, the cache line three levels down is fetched early
+    const EytzingerIndex &index = *accelerator.eytzinger;
+    const double *keys = index.keys();
+    std::size_t node = 1;
+    while (node <= index.size)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(keys + 8 * node);
+#endif
+        node = 2 * node + static_cast<std::size_t>(keys[node] < value);
+    }
+    // The last left turn is the first block whose last key is not below the value, drop the right turns after it
+    while (node & 1U)
+    {
+        node >>= 1;
+    }
+    node >>= 1;
+
+    // Every breakpoint before the block is below the value, count the ones below it inside the block
+    const std::size_t first = index.positions[node] * EytzingerIndex::block_size;
+    const std::size_t last = std::min(first + EytzingerIndex::block_size, size);
+    std::size_t result = first;
+    for (std::size_t i = first; i != last; ++i)
+    {
+        result += static_cast<std::size_t>(table(i) < value);
+    }
+    return result;
+}
+
+std::size_t LookupTable::SearchGallop(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const std::size_t &start_index) const
+{
+    // Edge cases and NaN input follow the binary search
+    const std::size_t size = table.size();
+    if (value <= table(0))
+    {
+        return 0;
+    }
+    else if (value >= table(size - 1))
+    {
+        return size;
+    }
+    else if (value != value)
+    {
+        return SearchBinary(value, table);
+    }
 
-        while (left < right)
+    // Double the step from the start index until the value is bracketed: table(lower) < value <= table(upper)
+    std::size_t lower = std::min(std::max(start_index, std::size_t(1)), size - 1);
+    std::size_t upper = lower;
+    std::size_t step = 1;
+    if (value <= table(upper))
+    {
+        do
+        {
+            upper = lower;
+            lower = upper > step ? upper - step : 0;
+            step *= 2;
+        } while (value <= table(lower));
+    }
+    else
+    {
+        do
         {
-            std::size_t mid = left + (right - left) / 2; // Avoid overflow with safer midpoint calculation
+            lower = upper;
+            upper = std::min(lower + step, size - 1);
+            step *= 2;
+        } while (value > table(upper));
+    }
 
-            if (value <= table(mid))
-            {
-                right = mid; // Narrow down to the left half
-            }
-            else
-            {
-                left = mid + 1; // Narrow down to the right half
-            }
+    // Binary search inside the bracket, O(log d) in total for a distance of d breakpoints
+    while (upper - lower > 1)
+    {
+        std::size_t mid = lower + (upper - lower) / 2;
+        if (value <= table(mid))
+        {
+            upper = mid;
+        }
+        else
+        {
+            lower = mid;
         }
-        return left;
     }
-    case SearchMethod::near:
+    return upper;
+}
+
+std::size_t LookupTable::SearchAdaptive(const double &value, const Eigen::Ref<const Eigen::RowVectorXd> &table, const AxisAccelerator &accelerator, const std::size_t &last_index, AdaptiveState &state) const
+{
+    // While the jumps are longer than log2(size) on average, galloping costs more than a plain binary search
+    const std::size_t size = table.size();
+    std::size_t index = 0;
+    const bool fallback = state.mean_jump > static_cast<float>(std::ilogb(static_cast<double>(size)));
+    if (fallback)
+    {
+        index = accelerator.eytzinger ? SearchEytzinger(value, table, accelerator) : SearchBinary(value, table);
+        RecordFallback();
+    }
+    else
     {
-        std::size_t index = last_index; // Start searching from the last known index
+        // Smooth inputs move by about the same number of breakpoints every step
+        std::ptrdiff_t predicted = static_cast<std::ptrdiff_t>(std::min(last_index, size)) + state.last_step;
+        predicted = std::min(std::max(predicted, std::ptrdiff_t(0)), static_cast<std::ptrdiff_t>(size));
+        index = SearchGallop(value, table, static_cast<std::size_t>(predicted));
+    }
+
+    std::ptrdiff_t step = static_cast<std::ptrdiff_t>(index) - static_cast<std::ptrdiff_t>(std::min(last_index, size));
+    state.last_step = static_cast<std::int32_t>(step);
+    state.mean_jump += 0.125f * (static_cast<float>(std::abs(step)) - state.mean_jump);
+    RecordSearch(index, last_index, size, !fallback);
+    return index;
+}
+
+LookupTable::AxisAccelerator LookupTable::BuildAxisAccelerator(const Eigen::Ref<const Eigen::RowVectorXd> &axis) const
+{
+    AxisAccelerator accelerator;
+    const Eigen::Index size = axis.size();
+    if (size < 2)
+    {
+        return accelerator;
+    }
+
+    // The axis is uniform if every breakpoint is within a few epsilon_ (relative to the axis magnitude) of the ideal grid
+    const double origin = axis(0);
+    const double step = (axis(size - 1) - origin) / static_cast<double>(size - 1);
+    const double tolerance = 4 * epsilon_ * std::max(std::abs(origin), std::abs(axis(size - 1)));
+    bool uniform = step > 0;
+    for (Eigen::Index index = 1; uniform && index < size - 1; ++index)
+    {
+        uniform = std::abs(axis(index) - (origin + index * step)) <= tolerance;
+    }
+    if (uniform)
+    {
+        accelerator.uniform = true;
+        accelerator.origin = origin;
+        accelerator.inverse_step = 1.0 / step;
+    }
+    else if (axis_index_enabled_ && static_cast<std::size_t>(size) >= axis_index_min_size_)
+    {
+        // Keys at 1..size, padding in front to align keys() to a cache line and behind for the children of the last level
+        const std::size_t line = 64 / sizeof(double);
+        std::shared_ptr<EytzingerIndex> index = std::make_shared<EytzingerIndex>();
+        index->size = (static_cast<std::size_t>(size) + EytzingerIndex::block_size - 1) / EytzingerIndex::block_size;
+        index->storage.assign(index->size + 2 * line, std::numeric_limits<double>::infinity());
+        index->positions.assign(index->size + 1, 0);
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(index->storage.data());
+        index->offset = ((64 - address % 64) % 64) / sizeof(double);
+        std::size_t next = 0;
+        FillEytzinger(axis, index->storage.data() + index->offset, index->positions.data(), index->size, 1, next);
+        accelerator.eytzinger = index;
+    }
+    return accelerator;
+}
 
-        // Handle case where index is out of range (larger than table size)
-        if (index >= table.size())
+Eigen::RowVectorXd LookupTable::SplineSlopes(const Eigen::RowVectorXd &x, const Eigen::RowVectorXd &y, const InterpMethod &method) const
+{
+    const Eigen::Index size = x.size();
+    Eigen::RowVectorXd slopes = Eigen::RowVectorXd::Zero(size);
+    if (size < 2 || y.size() != size)
+    {
+        return slopes;
+    }
+    const Eigen::Index segments = size - 1;
+    Eigen::RowVectorXd step = x.tail(segments) - x.head(segments);
+    Eigen::RowVectorXd secant = (y.tail(segments) - y.head(segments)).cwiseQuotient(step);
+    if (size == 2)
+    {
+        slopes.setConstant(secant(0)); // one segment, every method reduces to linear
+        return slopes;
+    }
+
+    switch (method)
+    {
+    case InterpMethod::cubic:
+    {
+        // Natural spline: solve the tridiagonal system for the second derivatives (zero at both ends), Thomas algorithm
+        Eigen::RowVectorXd second = Eigen::RowVectorXd::Zero(size);
+        Eigen::RowVectorXd diag(size), rhs(size);
+        for (Eigen::Index i = 1; i < segments; ++i)
         {
-            index = table.size(); // Set index to the last position
-            while (index > 0 && value < table(index - 1))
+            diag(i) = 2 * (step(i - 1) + step(i));
+            rhs(i) = 6 * (secant(i) - secant(i - 1));
+            if (i > 1)
             {
-                --index; // Move backward until the value is within the table's range
+                double factor = step(i - 1) / diag(i - 1);
+                diag(i) -= factor * step(i - 1);
+                rhs(i) -= factor * rhs(i - 1);
             }
         }
-        // Handle case where index is at the beginning of the table
-        else if (index == 0)
+        for (Eigen::Index i = segments - 1; i > 0; --i)
         {
-            while (index < table.size() && value > table(index))
-            {
-                ++index; // Move forward until the value fits within the table's range
-            }
+            second(i) = (rhs(i) - step(i) * second(i + 1)) / diag(i);
+        }
+        for (Eigen::Index i = 0; i < segments; ++i)
+        {
+            slopes(i) = secant(i) - step(i) * (2 * second(i) + second(i + 1)) / 6;
         }
-        // Forward search: if the new value is greater than or equal to the current position
-        else if (value >= table(index))
+        slopes(segments) = secant(segments - 1) + step(segments - 1) * (second(segments - 1) + 2 * second(segments)) / 6;
+        break;
+    }
+    case InterpMethod::pchip:
+    {
+        // Fritsch-Carlson: weighted harmonic mean of the secants, zero slope at local extrema
+        for (Eigen::Index i = 1; i < segments; ++i)
         {
-            while (index < table.size() && value > table(index))
+            if (secant(i - 1) * secant(i) > 0)
             {
-                ++index; // Continue forward search until the value fits within the range
+                double w1 = 2 * step(i) + step(i - 1);
+                double w2 = step(i) + 2 * step(i - 1);
+                slopes(i) = (w1 + w2) / (w1 / secant(i - 1) + w2 / secant(i));
             }
         }
-        // Backward search: if the new value is smaller than the previous position
-        else if (value <= table(index - 1))
-        {
-            while (index > 0 && value < table(index - 1))
+        // Shape-preserving three-point formula at the ends
+        auto end_slope = [](const double &h0, const double &h1, const double &d0, const double &d1) {
+            double slope = ((2 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+            if (slope * d0 <= 0)
+            {
+                return 0.0;
+            }
+            else if (d0 * d1 <= 0 && std::abs(slope) > std::abs(3 * d0))
             {
-                --index; // Continue backward search until the value fits within the range
+                return 3 * d0;
             }
+            return slope;
+        };
+        slopes(0) = end_slope(step(0), step(1), secant(0), secant(1));
+        slopes(segments) = end_slope(step(segments - 1), step(segments - 2), secant(segments - 1), secant(segments - 2));
+        break;
+    }
+    case InterpMethod::akima:
+    {
+        // Secants extended by two on each side, then the Akima weights
+        Eigen::RowVectorXd extended(segments + 4);
+        extended.segment(2, segments) = secant;
+        extended(1) = 2 * secant(0) - secant(1);
+        extended(0) = 2 * extended(1) - secant(0);
+        extended(segments + 2) = 2 * secant(segments - 1) - secant(segments - 2);
+        extended(segments + 3) = 2 * extended(segments + 2) - secant(segments - 1);
+        for (Eigen::Index i = 0; i < size; ++i)
+        {
+            double w1 = std::abs(extended(i + 3) - extended(i + 2));
+            double w2 = std::abs(extended(i + 1) - extended(i));
+            slopes(i) = (w1 + w2 < epsilon_) ? 0.5 * (extended(i + 1) + extended(i + 2)) : (w1 * extended(i + 1) + w2 * extended(i + 2)) / (w1 + w2);
         }
-
-        return index; // Return the index where the value fits within the table
+        break;
     }
     default:
     {
-        return last_index;
+        // Not a spline method, secant slopes
+        slopes.head(segments) = secant;
+        slopes(segments) = secant(segments - 1);
+        break;
+    }
+    }
+    return slopes;
+}
+
+void LookupTable::HermiteBasis(const double &weight, const double &step, const bool &spline, double *value_basis, double *slope_basis) const
+{
+    if (spline)
+    {
+        const double weight2 = weight * weight;
+        const double weight3 = weight2 * weight;
+        value_basis[0] = 2 * weight3 - 3 * weight2 + 1;
+        value_basis[1] = -2 * weight3 + 3 * weight2;
+        slope_basis[0] = (weight3 - 2 * weight2 + weight) * step;
+        slope_basis[1] = (weight3 - weight2) * step;
+    }
+    else
+    {
+        value_basis[0] = 1 - weight;
+        value_basis[1] = weight;
+        slope_basis[0] = 0;
+        slope_basis[1] = 0;
+    }
+}
+
+void LookupTable::HermiteBasisDerivative(const double &weight, const double &step, const bool &spline, double *value_basis, double *slope_basis) const
+{
+    if (spline)
+    {
+        const double weight2 = weight * weight;
+        value_basis[0] = (6 * weight2 - 6 * weight) / step;
+        value_basis[1] = (6 * weight - 6 * weight2) / step;
+        slope_basis[0] = 3 * weight2 - 4 * weight + 1;
+        slope_basis[1] = 3 * weight2 - 2 * weight;
     }
+    else
+    {
+        value_basis[0] = -1 / step;
+        value_basis[1] = 1 / step;
+        slope_basis[0] = 0;
+        slope_basis[1] = 0;
     }
 }
 
-bool LookupTable::isStrictlyIncreasing(const Eigen::RowVectorXd &input_vector)
+bool LookupTable::isStrictlyIncreasing(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector)
 {
     for (size_t index = 1; index < input_vector.size(); ++index)
     {
@@ -106,6 +471,27 @@ bool LookupTable::isStrictlyIncreasing(const Eigen::RowVectorXd &input_vector)
     return true;
 }
 
+LookupTable::Monotonicity LookupTable::CheckMonotonicity(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector)
+{
+    if (isStrictlyIncreasing(input_vector))
+    {
+        return Monotonicity::increasing;
+    }
+    return isStrictlyIncreasing(-input_vector) ? Monotonicity::decreasing : Monotonicity::none;
+}
+
+// Zeroed coefficient storage for count groups of stride values, aligned as described in SegmentCoefficients
+std::shared_ptr<LookupTable::SegmentCoefficients> LookupTable::AllocateSegmentCoefficients(const std::size_t &count, const std::size_t &stride) const
+{
+    std::shared_ptr<SegmentCoefficients> coeffs = std::make_shared<SegmentCoefficients>();
+    const std::size_t line = 64 / sizeof(double);
+    coeffs->storage.assign(count * stride + line, 0.0);
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(coeffs->storage.data());
+    coeffs->offset = ((64 - address % 64) % 64) / sizeof(double);
+    coeffs->stride = stride;
+    return coeffs;
+}
+
 bool LookupTable::ReportError()
 {
     /* This function depends on the system, finish it as soon as possible */
@@ -19,10 +19,36 @@ LookupTable::AssignmentState LookupTable1D::AssignTableData(const Eigen::RowVect
 }
 LookupTable::AssignmentState LookupTable1D::AssignTableData(const std::vector<double> &x_vec, const std::vector<double> &y_vec)
 {
-    // this is vector edition, first convert then call the base AssignTableData function.
-    Eigen::RowVectorXd x_axis = Eigen::Map<const Eigen::RowVectorXd>(x_vec.data(), x_vec.size());
-    Eigen::RowVectorXd y_table = Eigen::Map<const Eigen::RowVectorXd>(y_vec.data(), y_vec.size());
-    return AssignTableData(x_axis, y_table);
+    // this is vector edition, validate through maps so the data is copied once, straight into the table
+    Eigen::Map<const Eigen::RowVectorXd> x_axis(x_vec.data(), x_vec.size());
+    Eigen::Map<const Eigen::RowVectorXd> y_table(y_vec.data(), y_vec.size());
+    if (CheckTableState(x_axis, y_table) == TableState::valid)
+    {
+        x_axis_ = x_axis;
+        y_table_ = y_table;
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+}
+LookupTable::AssignmentState LookupTable1D::AssignTableData(Eigen::RowVectorXd &&x_axis, Eigen::RowVectorXd &&y_table)
+{
+    if (CheckTableState(x_axis, y_table) == TableState::valid)
+    {
+        x_axis_ = std::move(x_axis);
+        y_table_ = std::move(y_table);
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
 }
 // AssignTableData is related with three functions: CheckTableState, RefreshTableState, ClearTable.
 inline bool LookupTable1D::ClearTable()
@@ -33,6 +59,10 @@ inline bool LookupTable1D::ClearTable()
     table_empty_ = true;
     table_size_ = 0;
     table_state_ = TableState::empty;
+    x_accelerator_ = AxisAccelerator();
+    spline_coeffs_.resize(4, 0);
+    linear_coeffs_.reset();
+    BuildInverse();
     return true;
 }
 
@@ -46,17 +76,25 @@ inline bool LookupTable1D::RefreshTableState()
         table_valid_ = true;
         table_empty_ = false;
         table_size_ = x_size;
+        x_accelerator_ = BuildAxisAccelerator(x_axis_);
+        BuildSplineCoefficients();
+        BuildLinearCoefficients();
+        BuildInverse();
     }
     else
     {
         table_valid_ = false;
         table_empty_ = table_state_ == TableState::empty;
         table_size_ = (x_size < y_size) ? x_size : y_size;
+        x_accelerator_ = AxisAccelerator();
+        BuildSplineCoefficients();
+        BuildLinearCoefficients();
+        BuildInverse();
     }
     return table_valid_;
 }
 
-LookupTable::TableState LookupTable1D::CheckTableState(const Eigen::RowVectorXd &input_vector1, const Eigen::RowVectorXd &input_vector2)
+LookupTable::TableState LookupTable1D::CheckTableState(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector1, const Eigen::Ref<const Eigen::RowVectorXd> &input_vector2)
 {
     if (input_vector1.size() == 0 || input_vector2.size() == 0)
     {
@@ -81,6 +119,11 @@ LookupTable::TableState LookupTable1D::CheckTableState(const Eigen::RowVectorXd
 }
 
 // Configurations of lookup methods
+void LookupTable1D::SetInterpMethod(const InterpMethod &method)
+{
+    interp_method_ = method;
+    BuildSplineCoefficients();
+}
 void LookupTable1D::SetExtrapMethod(const ExtrapMethod &method)
 {
     extrap_method_ = method;
@@ -97,16 +140,27 @@ void LookupTable1D::SetExtrapMethod(const ExtrapMethod &method, const double &lo
     upper_extrap_value_specify_ = upper_value;
 }
 
+void LookupTable1D::SetAxisIndex(const bool &enable)
+{
+    axis_index_enabled_ = enable;
+    x_accelerator_ = table_valid_ ? BuildAxisAccelerator(x_axis_) : AxisAccelerator();
+}
+void LookupTable1D::SetSegmentCoefficients(const bool &enable)
+{
+    segment_coeffs_enabled_ = enable;
+    BuildLinearCoefficients();
+}
+
 // Prelook
 std::size_t LookupTable1D::PreLookup(const double &xvalue)
 {
-    size_t prelook_index = SearchIndex(xvalue, x_axis_, search_method_, prelook_index_);
+    size_t prelook_index = SearchAxis(xvalue, x_axis_, x_accelerator_, search_method_, prelook_index_, x_adaptive_);
     size_t x_size = ConvertSizeDataType(x_axis_.size());
     if (prelook_index >= 0 && prelook_index <= x_size) // valid prelookup
     {
         prelook_index_ = prelook_index; // store value
         if (search_method_ != SearchMethod::near)
-            search_method_ = SearchMethod::near;    // set to near after binary search
+            search_method_ = NextSearchMethod(search_method_);    // set to near after the first search, adaptive stays adaptive
     }
     else
     {
@@ -117,146 +171,498 @@ std::size_t LookupTable1D::PreLookup(const double &xvalue)
 }
 
 // Interpolation between the two closest points
-double LookupTable1D::Interpolation(const std::size_t &index, const double &xvalue)
+double LookupTable1D::Interpolation(const std::size_t &index, const double &xvalue) const
 {
+    if (isSplineMethod(interp_method_))
+    {
+        return InterpolationSpline(index, xvalue);
+    }
+    else if (interp_method_ == InterpMethod::linear && linear_coeffs_)
+    {
+        const double *coeffs = linear_coeffs_->segment(index - 1);
+        return coeffs[0] + coeffs[1] * (xvalue - x_axis_(index - 1));
+    }
+    double result = lookup_result_;
+    EvaluateSegment(index, table_size_, xvalue, x_axis_.data(), [this](const std::size_t &i) { return y_table_(i); }, lower_extrap_value_specify_, upper_extrap_value_specify_, result);
+    return result;
+}
+void LookupTable1D::InterpolationBatch(const std::size_t *index, const double *xvalues, double *results, const std::size_t &count) const
+{
+    // Gather the segment end points, samples to be extrapolated are clamped onto the end segments and patched below
+    BatchArray xv = Eigen::Map<const BatchArray>(xvalues, count);
+    BatchArray x1(count), x2(count), y1(count), y2(count), output(count);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        std::size_t segment = std::min(std::max(index[i], std::size_t(1)), table_size_ - 1);
+        x1(i) = x_axis_(segment - 1);
+        x2(i) = x_axis_(segment);
+        y1(i) = y_table_(segment - 1);
+        y2(i) = y_table_(segment);
+    }
+
+    // Same operations in the same order as the scalar functions, so the results match bit for bit
     switch (interp_method_)
     {
     case InterpMethod::linear:
-        return InterpolationLinear(index, xvalue);
-
+    {
+        if (linear_coeffs_)
+        {
+            BatchArray intercept(count), slope(count);
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                const double *coeffs = linear_coeffs_->segment(std::min(std::max(index[i], std::size_t(1)), table_size_ - 1) - 1);
+                intercept(i) = coeffs[0];
+                slope(i) = coeffs[1];
+            }
+            output = intercept + slope * (xv - x1);
+            break;
+        }
+        BatchArray dx = x2 - x1;
+        BatchArray weight = (dx.abs() < epsilon_).select(0.5, (xv - x1) / dx);
+        output = y1 + weight * (y2 - y1);
+        break;
+    }
     case InterpMethod::nearest:
-        return InterpolationNearest(index, xvalue);
-
+        output = ((xv - x1) <= (x2 - xv)).select(y1, y2);
+        break;
     case InterpMethod::next:
-        return InterpolationNext(index, xvalue);
-
+        output = y2;
+        break;
     case InterpMethod::previous:
-        return InterpolationPrevious(index, xvalue);
-
+        output = y1;
+        break;
+    case InterpMethod::cubic:
+    case InterpMethod::pchip:
+    case InterpMethod::akima:
+    {
+        BatchArray a(count), b(count), c(count), d(count);
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            std::size_t segment = std::min(std::max(index[i], std::size_t(1)), table_size_ - 1) - 1;
+            a(i) = spline_coeffs_(0, segment);
+            b(i) = spline_coeffs_(1, segment);
+            c(i) = spline_coeffs_(2, segment);
+            d(i) = spline_coeffs_(3, segment);
+        }
+        BatchArray t = xv - x1;
+        output = a + t * (b + t * (c + t * d));
+        break;
+    }
     default:
-        bool refresh = RefreshTableState();
-        return lookup_result_;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            output(i) = Interpolation(std::max(index[i], std::size_t(1)), xvalues[i]);
+        }
+        break;
+    }
+
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        results[i] = (index[i] == 0 || index[i] == table_size_) ? Extrapolation(index[i], xvalues[i]) : output(i);
     }
 }
-double LookupTable1D::InterpolationLinear(const std::size_t &index, const double &xvalue)
+double LookupTable1D::InterpolationSpline(const std::size_t &index, const double &xvalue) const
 {
-    // Interpolate 1D
-    return Interpolate(xvalue, x_axis_(index - 1), x_axis_(index), y_table_(index - 1), y_table_(index));
+    // Horner evaluation of the segment polynomial
+    const double t = xvalue - x_axis_(index - 1);
+    return spline_coeffs_(0, index - 1) + t * (spline_coeffs_(1, index - 1) + t * (spline_coeffs_(2, index - 1) + t * spline_coeffs_(3, index - 1)));
 }
-double LookupTable1D::InterpolationNearest(const std::size_t &index, const double &xvalue)
+void LookupTable1D::BuildSplineCoefficients()
 {
-    return ((xvalue - x_axis_(index - 1)) <= (x_axis_(index) - xvalue)) ? y_table_(index - 1) : y_table_(index);
+    if (!table_valid_ || !isSplineMethod(interp_method_))
+    {
+        spline_coeffs_.resize(4, 0);
+        return;
+    }
+
+    // Cubic Hermite segments from the node slopes of the chosen method, expanded into polynomial coefficients
+    const Eigen::Index segments = x_axis_.size() - 1;
+    Eigen::RowVectorXd slopes = SplineSlopes(x_axis_, y_table_, interp_method_);
+    spline_coeffs_.resize(4, segments);
+    for (Eigen::Index i = 0; i < segments; ++i)
+    {
+        const double step = x_axis_(i + 1) - x_axis_(i);
+        const double secant = (y_table_(i + 1) - y_table_(i)) / step;
+        spline_coeffs_(0, i) = y_table_(i);
+        spline_coeffs_(1, i) = slopes(i);
+        spline_coeffs_(2, i) = (3 * secant - 2 * slopes(i) - slopes(i + 1)) / step;
+        spline_coeffs_(3, i) = (slopes(i) + slopes(i + 1) - 2 * secant) / (step * step);
+    }
 }
-double LookupTable1D::InterpolationNext(const std::size_t &index, const double &xvalue)
+void LookupTable1D::BuildLinearCoefficients()
 {
-    return y_table_(index);
+    if (!table_valid_ || !segment_coeffs_enabled_)
+    {
+        linear_coeffs_.reset();
+        return;
+    }
+
+    // The axis is strictly increasing, so every step is at least epsilon_ and the weight formula never takes its 0.5 branch
+    const std::size_t segments = table_size_ - 1;
+    std::shared_ptr<SegmentCoefficients> coeffs = AllocateSegmentCoefficients(segments, 2);
+    for (std::size_t i = 0; i != segments; ++i)
+    {
+        double *segment = coeffs->storage.data() + coeffs->offset + 2 * i;
+        segment[0] = y_table_(i);
+        segment[1] = (y_table_(i + 1) - y_table_(i)) / (x_axis_(i + 1) - x_axis_(i));
+    }
+    linear_coeffs_ = coeffs;
 }
-double LookupTable1D::InterpolationPrevious(const std::size_t &index, const double &xvalue)
+
+// Extrapolation if input is out of bounds
+double LookupTable1D::Extrapolation(const std::size_t &index, const double &xvalue) const
 {
-    return y_table_(index - 1);
+    if (extrap_method_ == ExtrapMethod::linear && linear_coeffs_ && (index == 0 || index == table_size_))
+    {
+        // Extend the first or the last segment
+        const std::size_t segment = index == 0 ? 0 : table_size_ - 2;
+        const double *coeffs = linear_coeffs_->segment(segment);
+        return coeffs[0] + coeffs[1] * (xvalue - x_axis_(segment));
+    }
+    double result = lookup_result_;
+    EvaluateSegment(index, table_size_, xvalue, x_axis_.data(), [this](const std::size_t &i) { return y_table_(i); }, lower_extrap_value_specify_, upper_extrap_value_specify_, result);
+    return result;
 }
 
-// Extrapolation if input is out of bounds
-double LookupTable1D::Extrapolation(const std::size_t &index, const double &xvalue)
+// Final function LookupTable
+double LookupTable1D::Lookup(const double &xvalue)
 {
-    switch (extrap_method_)
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        size_t index = PreLookup(xvalue);
+        if (index == 0 || index == table_size_) // in the case for extrapolation
+        {
+            lookup_result_ = Extrapolation(index, xvalue);
+        }
+        else
+        {
+            lookup_result_ = Interpolation(index, xvalue);
+        }
+        xvalue_ = xvalue; // restore the input value to member variable, for use in some cases.
+    }
+    else
     {
-    case ExtrapMethod::clip:
-        return ExtrapolationClip(index);
-    case ExtrapMethod::linear:
-        return ExtrapolationLinear(index, xvalue);
-    case ExtrapMethod::specify:
-        return ExtrapolationSpecify(index, lower_extrap_value_specify_, upper_extrap_value_specify_);
-    default:
         bool refresh = RefreshTableState();
-        return lookup_result_;
+    }
+    return lookup_result_;
+}
+
+// Batch lookup, the search method is resolved once and the interpolation runs on blocks of samples
+void LookupTable1D::LookupBatch(const double *xvalues, double *results, const std::size_t &count, const SearchMethod &first_method, std::size_t &index, AdaptiveState &adaptive) const
+{
+    CountLookups(count);
+    std::size_t index_block[batch_block_size_];
+    const SearchMethod next_method = NextSearchMethod(first_method);
+    index = SearchAxis(xvalues[0], x_axis_, x_accelerator_, first_method, index, adaptive); // the first sample uses the given method, then near search
+    for (std::size_t start = 0; start < count; start += batch_block_size_)
+    {
+        const std::size_t block = (count - start < batch_block_size_) ? count - start : batch_block_size_;
+        for (std::size_t i = 0; i != block; ++i)
+        {
+            if (start + i != 0)
+            {
+                index = SearchAxis(xvalues[start + i], x_axis_, x_accelerator_, next_method, index, adaptive);
+            }
+            index_block[i] = index;
+        }
+        InterpolationBatch(index_block, xvalues + start, results + start, block);
     }
 }
-double LookupTable1D::ExtrapolationClip(const std::size_t &index)
+void LookupTable1D::Lookup(const double *xvalues, double *results, const std::size_t &count)
 {
-    if (index == 0)
+    if (count == 0)
     {
-        return y_table_(0);
+        return;
     }
-    else if (index == table_size_)
+    if (!table_valid_)
     {
-        return y_table_(y_table_.size() - 1);
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        return;
     }
-    else
+
+    LookupBatch(xvalues, results, count, search_method_, prelook_index_, x_adaptive_);
+    search_method_ = NextSearchMethod(search_method_); // same as PreLookup after a valid search
+    xvalue_ = xvalues[count - 1];
+    lookup_result_ = results[count - 1];
+}
+void LookupTable1D::Lookup(const std::vector<double> &xvalues, std::vector<double> &results)
+{
+    results.resize(xvalues.size());
+    Lookup(xvalues.data(), results.data(), xvalues.size());
+}
+void LookupTable1D::Lookup(const Eigen::Ref<const Eigen::RowVectorXd> &xvalues, Eigen::Ref<Eigen::RowVectorXd> results)
+{
+    std::size_t count = ConvertSizeDataType(std::min(xvalues.size(), results.size()));
+    Lookup(xvalues.data(), results.data(), count);
+}
+
+// Thread-safe lookup, only the cursor is written
+double LookupTable1D::Lookup(const double &xvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
     {
-        return lookup_result_; // if failure occurs, output the last value.
+        std::size_t index = SearchAxis(xvalue, x_axis_, x_accelerator_, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index, cursor.row_adaptive);
+        cursor.row_index = index;
+        cursor.primed = true;
+        cursor.result = (index == 0 || index == table_size_) ? Extrapolation(index, xvalue) : Interpolation(index, xvalue);
     }
+    return cursor.result;
 }
-double LookupTable1D::ExtrapolationLinear(const std::size_t &index, const double &xvalue)
+void LookupTable1D::Lookup(const double *xvalues, double *results, const std::size_t &count, LookupCursor &cursor) const
 {
-    if (index == 0)
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
     {
-        double x1 = x_axis_(0);
-        double x2 = x_axis_(1);
-        double y1 = y_table_(0);
-        double y2 = y_table_(1);
+        std::fill(results, results + count, cursor.result);
+        return;
+    }
 
-        // Calculate the weight for linear extrapolation
-        bool equal_zero = std::abs(x2 - x1) < epsilon_;
-        double weight = equal_zero ? 0.5 : (xvalue - x1) / (x2 - x1);
+    LookupBatch(xvalues, results, count, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index, cursor.row_adaptive);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+void LookupTable1D::Lookup(const std::vector<double> &xvalues, std::vector<double> &results, LookupCursor &cursor) const
+{
+    results.resize(xvalues.size());
+    Lookup(xvalues.data(), results.data(), xvalues.size(), cursor);
+}
 
-        // Linearly extrapolate the y value based on the weight
-        return y1 + weight * (y2 - y1);
+// Interpolation with a shared prelookup, same formulas as Interpolation and Extrapolation with the weight given
+double LookupTable1D::Lookup(const PrelookupResult &prelookup) const
+{
+    LookupTimer timer = StartLookupTimer();
+    const std::size_t &index = prelookup.index;
+    const double &fraction = prelookup.fraction;
+    if (!table_valid_ || index > table_size_)
+    {
+        return lookup_result_; // invalid table or prelookup from a different axis, keep last value
     }
-    else if (index == table_size_)
+    const std::size_t segment = std::min(std::max(index, std::size_t(1)), table_size_ - 1);
+    const double &y1 = y_table_(segment - 1);
+    const double &y2 = y_table_(segment);
+    if (index == 0 || index == table_size_)
     {
-        double x1 = x_axis_(table_size_ - 2);
-        double x2 = x_axis_(table_size_ - 1);
-        double y1 = y_table_(table_size_ - 2);
-        double y2 = y_table_(table_size_ - 1);
+        switch (extrap_method_)
+        {
+        case ExtrapMethod::linear:
+            return y1 + fraction * (y2 - y1);
+        case ExtrapMethod::specify:
+            return index == 0 ? lower_extrap_value_specify_ : upper_extrap_value_specify_;
+        default:
+            return index == 0 ? y1 : y2;
+        }
+    }
+    switch (interp_method_)
+    {
+    case InterpMethod::linear:
+        return y1 + fraction * (y2 - y1);
+    case InterpMethod::nearest:
+        return fraction <= 0.5 ? y1 : y2;
+    case InterpMethod::next:
+        return y2;
+    case InterpMethod::previous:
+        return y1;
+    case InterpMethod::cubic:
+    case InterpMethod::pchip:
+    case InterpMethod::akima:
+    {
+        const double t = fraction * (x_axis_(segment) - x_axis_(segment - 1));
+        return spline_coeffs_(0, segment - 1) + t * (spline_coeffs_(1, segment - 1) + t * (spline_coeffs_(2, segment - 1) + t * spline_coeffs_(3, segment - 1)));
+    }
+    default:
+        return lookup_result_;
+    }
+}
 
-        // Calculate the weight for linear extrapolation
-        bool equal_zero = std::abs(x2 - x1) < epsilon_;
-        double weight = equal_zero ? 0.5 : (xvalue - x1) / (x2 - x1);
 
-        // Linearly extrapolate the y value based on the weight
-        return y1 + weight * (y2 - y1);
+// Inverse lookup, the y values are used as the search axis
+void LookupTable1D::BuildInverse()
+{
+    y_monotonicity_ = table_valid_ ? CheckMonotonicity(y_table_) : Monotonicity::none;
+    inverse_primed_ = false;
+    if (y_monotonicity_ == Monotonicity::none)
+    {
+        inverse_axis_.resize(0);
+        inverse_values_.resize(0);
+        inverse_accelerator_ = AxisAccelerator();
+        return;
     }
-    else
+    const bool increasing = y_monotonicity_ == Monotonicity::increasing;
+    inverse_axis_ = increasing ? y_table_ : Eigen::RowVectorXd(y_table_.reverse());
+    inverse_values_ = increasing ? x_axis_ : Eigen::RowVectorXd(x_axis_.reverse());
+    inverse_accelerator_ = BuildAxisAccelerator(inverse_axis_);
+}
+double LookupTable1D::InverseInterpolation(const std::size_t &index, const double &yvalue) const
+{
+    if ((index == 0 || index == table_size_) && extrap_method_ != ExtrapMethod::linear)
     {
-        return lookup_result_; // if failure occurs, output the last value.
+        return index == 0 ? inverse_values_(0) : inverse_values_(table_size_ - 1);
     }
+    const std::size_t segment = std::min(std::max(index, std::size_t(1)), table_size_ - 1);
+    return Interpolate(yvalue, inverse_axis_(segment - 1), inverse_axis_(segment), inverse_values_(segment - 1), inverse_values_(segment));
 }
-double LookupTable1D::ExtrapolationSpecify(const std::size_t &index, const double &lower_extrap_value, const double &upper_extrap_value)
+double LookupTable1D::InverseLookup(const double &yvalue)
 {
-    if (index == 0)
+    if (y_monotonicity_ != Monotonicity::none)
     {
-        return lower_extrap_value;
+        const SearchMethod method = inverse_primed_ ? NextSearchMethod(search_method_) : search_method_;
+        inverse_index_ = SearchAxis(yvalue, inverse_axis_, inverse_accelerator_, method, inverse_index_, inverse_adaptive_);
+        inverse_primed_ = true;
+        inverse_result_ = InverseInterpolation(inverse_index_, yvalue);
     }
-    else if (index == table_size_)
+    return inverse_result_;
+}
+double LookupTable1D::InverseLookup(const double &yvalue, LookupCursor &cursor) const
+{
+    if (y_monotonicity_ != Monotonicity::none)
     {
-        return upper_extrap_value;
+        const SearchMethod method = cursor.primed ? NextSearchMethod(search_method_) : search_method_;
+        cursor.row_index = SearchAxis(yvalue, inverse_axis_, inverse_accelerator_, method, cursor.row_index, cursor.row_adaptive);
+        cursor.primed = true;
+        cursor.result = InverseInterpolation(cursor.row_index, yvalue);
     }
-    else
+    return cursor.result;
+}
+
+// Value and derivative, the value takes the same path as Lookup
+double LookupTable1D::Derivative(const std::size_t &index, const double &xvalue) const
+{
+    if (index == 0 || index == table_size_)
+    {
+        const std::size_t segment = index == 0 ? 1 : table_size_ - 1;
+        return extrap_method_ == ExtrapMethod::linear ? (y_table_(segment) - y_table_(segment - 1)) / (x_axis_(segment) - x_axis_(segment - 1)) : 0.0;
+    }
+    switch (interp_method_)
+    {
+    case InterpMethod::linear:
+        return linear_coeffs_ ? linear_coeffs_->segment(index - 1)[1] : (y_table_(index) - y_table_(index - 1)) / (x_axis_(index) - x_axis_(index - 1));
+    case InterpMethod::cubic:
+    case InterpMethod::pchip:
+    case InterpMethod::akima:
+    {
+        const double t = xvalue - x_axis_(index - 1);
+        return spline_coeffs_(1, index - 1) + t * (2 * spline_coeffs_(2, index - 1) + t * 3 * spline_coeffs_(3, index - 1));
+    }
+    default:
+        return 0.0;
+    }
+}
+void LookupTable1D::LookupGradientBatch(const double *xvalues, double *results, double *derivatives, const std::size_t &count, const SearchMethod &first_method, std::size_t &index, AdaptiveState &adaptive) const
+{
+    CountLookups(count);
+    const SearchMethod next_method = NextSearchMethod(first_method);
+    for (std::size_t i = 0; i != count; ++i)
     {
-        return lookup_result_; // if failure occurs, output the last value.
+        index = SearchAxis(xvalues[i], x_axis_, x_accelerator_, i == 0 ? first_method : next_method, index, adaptive);
+        results[i] = (index == 0 || index == table_size_) ? Extrapolation(index, xvalues[i]) : Interpolation(index, xvalues[i]);
+        derivatives[i] = Derivative(index, xvalues[i]);
     }
 }
+double LookupTable1D::LookupGradient(const double &xvalue, double &derivative)
+{
+    LookupGradient(&xvalue, &lookup_result_, &derivative, 1);
+    return lookup_result_;
+}
+double LookupTable1D::LookupGradient(const double &xvalue, double &derivative, LookupCursor &cursor) const
+{
+    LookupGradient(&xvalue, &cursor.result, &derivative, 1, cursor);
+    return cursor.result;
+}
+void LookupTable1D::LookupGradient(const double *xvalues, double *results, double *derivatives, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        std::fill(derivatives, derivatives + count, 0.0);
+        return;
+    }
 
-// Final function LookupTable
-double LookupTable1D::Lookup(const double &xvalue)
+    LookupGradientBatch(xvalues, results, derivatives, count, search_method_, prelook_index_, x_adaptive_);
+    search_method_ = NextSearchMethod(search_method_);
+    xvalue_ = xvalues[count - 1];
+    lookup_result_ = results[count - 1];
+}
+void LookupTable1D::LookupGradient(const double *xvalues, double *results, double *derivatives, const std::size_t &count, LookupCursor &cursor) const
 {
-    if (table_valid_)
+    if (count == 0)
     {
-        size_t index = PreLookup(xvalue);
-        if (index == 0 || index == table_size_) // in the case for extrapolation
-        {
-            lookup_result_ = Extrapolation(index, xvalue);
-        }
-        else
+        return;
+    }
+    if (!table_valid_)
+    {
+        std::fill(results, results + count, cursor.result);
+        std::fill(derivatives, derivatives + count, 0.0);
+        return;
+    }
+
+    LookupGradientBatch(xvalues, results, derivatives, count, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index, cursor.row_adaptive);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+
+// Sorted lookup, the merge pass replaces the search, interpolation runs on blocks like the batch lookup
+void LookupTable1D::LookupMergeBatch(const double *xvalues, double *results, const std::size_t &count, std::size_t &index) const
+{
+    CountLookups(count);
+    std::size_t index_block[batch_block_size_];
+    const double *axis = x_axis_.data();
+    for (std::size_t start = 0; start < count; start += batch_block_size_)
+    {
+        const std::size_t block = (count - start < batch_block_size_) ? count - start : batch_block_size_;
+        for (std::size_t i = 0; i != block; ++i)
         {
-            lookup_result_ = Interpolation(index, xvalue);
+            index = SearchMerge(xvalues[start + i], axis, table_size_, index);
+            index_block[i] = index;
         }
-        xvalue_ = xvalue; // restore the input value to member variable, for use in some cases.
+        InterpolationBatch(index_block, xvalues + start, results + start, block);
     }
-    else
+}
+void LookupTable1D::LookupSorted(const double *xvalues, double *results, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
     {
         bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        return;
     }
-    return lookup_result_;
-}
\ No newline at end of file
+
+    LookupMergeBatch(xvalues, results, count, prelook_index_);
+    xvalue_ = xvalues[count - 1];
+    lookup_result_ = results[count - 1];
+}
+void LookupTable1D::LookupSorted(const double *xvalues, double *results, const std::size_t &count, LookupCursor &cursor) const
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        std::fill(results, results + count, cursor.result);
+        return;
+    }
+
+    LookupMergeBatch(xvalues, results, count, cursor.row_index);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+void LookupTable1D::LookupSorted(const std::vector<double> &xvalues, std::vector<double> &results, LookupCursor &cursor) const
+{
+    results.resize(xvalues.size());
+    LookupSorted(xvalues.data(), results.data(), xvalues.size(), cursor);
+}
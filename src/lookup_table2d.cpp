@@ -4,7 +4,7 @@
 // Assign table data
 LookupTable::AssignmentState LookupTable2D::AssignTableData(const Eigen::RowVectorXd &row_axis, const Eigen::RowVectorXd &col_axis, const Eigen::MatrixXd &map_matrix)
 {
-    if (CheckTableState(row_axis, col_axis, map_matrix) == TableState::valid)
+    if (CheckTableState(row_axis, col_axis, map_matrix.rows(), map_matrix.cols()) == TableState::valid)
     {
         row_axis_ = row_axis;
         col_axis_ = col_axis;
@@ -20,14 +20,19 @@ LookupTable::AssignmentState LookupTable2D::AssignTableData(const Eigen::RowVect
 }
 LookupTable::AssignmentState LookupTable2D::AssignTableData(const std::vector<double> &row_vec, const std::vector<double> &col_vec, const std::vector<double> &map_vec)
 {
+    // the map is stored row by row, validate through maps and copy it once into the column-major matrix
+    typedef Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> RowMajorMap;
     std::size_t rows = ConvertSizeDataType(row_vec.size());
     std::size_t cols = ConvertSizeDataType(col_vec.size());
-    if (rows * cols == map_vec.size())
+    Eigen::Map<const Eigen::RowVectorXd> row_axis(row_vec.data(), rows);
+    Eigen::Map<const Eigen::RowVectorXd> col_axis(col_vec.data(), cols);
+    if (rows * cols == map_vec.size() && CheckTableState(row_axis, col_axis, rows, cols) == TableState::valid)
     {
-        Eigen::RowVectorXd row_axis = Eigen::Map<const Eigen::RowVectorXd>(row_vec.data(), rows);
-        Eigen::RowVectorXd col_axis = Eigen::Map<const Eigen::RowVectorXd>(col_vec.data(), cols);
-        Eigen::MatrixXd map_matrix = Eigen::Map<const Eigen::MatrixXd>(map_vec.data(), cols, rows).transpose();
-        return AssignTableData(row_axis, col_axis, map_matrix);
+        row_axis_ = row_axis;
+        col_axis_ = col_axis;
+        map_matrix_ = RowMajorMap(map_vec.data(), rows, cols);
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
     }
     else
     {
@@ -35,21 +40,43 @@ LookupTable::AssignmentState LookupTable2D::AssignTableData(const std::vector<do
         return valid ? AssignmentState::remain : AssignmentState::fail; // return assignment state
     }
 }
+LookupTable::AssignmentState LookupTable2D::AssignTableData(Eigen::RowVectorXd &&row_axis, Eigen::RowVectorXd &&col_axis, Eigen::MatrixXd &&map_matrix)
+{
+    if (CheckTableState(row_axis, col_axis, map_matrix.rows(), map_matrix.cols()) == TableState::valid)
+    {
+        row_axis_ = std::move(row_axis);
+        col_axis_ = std::move(col_axis);
+        map_matrix_ = std::move(map_matrix);
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+}
 
 bool LookupTable2D::ClearTable()
 {
     row_axis_.resize(0);
     col_axis_.resize(0);
     map_matrix_.resize(0, 0);
+    table_valid_ = false;
     table_empty_ = true;
     table_size_ = {0, 0};
     table_state_ = TableState::empty;
+    row_accelerator_ = AxisAccelerator();
+    col_accelerator_ = AxisAccelerator();
+    BuildSplineSlopes();
+    cell_coeffs_.reset();
+    col_monotonicity_ = Monotonicity::none;
     return true;
 }
 
 inline bool LookupTable2D::RefreshTableState()
 {
-    table_state_ = CheckTableState(row_axis_, col_axis_, map_matrix_);
+    table_state_ = CheckTableState(row_axis_, col_axis_, map_matrix_.rows(), map_matrix_.cols());
     std::size_t rows = ConvertSizeDataType(row_axis_.size());
     std::size_t cols = ConvertSizeDataType(col_axis_.size());
     table_size_ = {rows, cols};
@@ -57,26 +84,36 @@ inline bool LookupTable2D::RefreshTableState()
     {
         table_valid_ = true;
         table_empty_ = false;
+        row_accelerator_ = BuildAxisAccelerator(row_axis_);
+        col_accelerator_ = BuildAxisAccelerator(col_axis_);
+        BuildSplineSlopes();
+        BuildCellCoefficients();
+        BuildInverse();
     }
     else
     {
         table_valid_ = false;
         table_empty_ = table_state_ == TableState::empty;
+        row_accelerator_ = AxisAccelerator();
+        col_accelerator_ = AxisAccelerator();
+        BuildSplineSlopes();
+        BuildCellCoefficients();
+        BuildInverse();
     }
     return table_valid_;
 }
 
-LookupTable::TableState LookupTable2D::CheckTableState(const Eigen::RowVectorXd &input_vector1, const Eigen::RowVectorXd &input_vector2, const Eigen::MatrixXd &input_matrix)
+LookupTable::TableState LookupTable2D::CheckTableState(const Eigen::Ref<const Eigen::RowVectorXd> &input_vector1, const Eigen::Ref<const Eigen::RowVectorXd> &input_vector2, const Eigen::Index &rows, const Eigen::Index &cols)
 {
-    if (input_vector1.data() == nullptr && input_vector2.data() == nullptr && input_matrix.data() == nullptr)
+    if (input_vector1.size() == 0 && input_vector2.size() == 0 && rows * cols == 0)
     {
         return LookupTable::TableState::empty;
     }
-    else if (input_vector1.size() < 2 || input_vector1.size() > max_table_size_ || input_vector2.size() < 2 || input_vector2.size() > max_table_size_ || input_matrix.rows() < 2 || input_matrix.rows() > max_table_size_ || input_matrix.cols() < 2 || input_matrix.cols() > max_table_size_)
+    else if (input_vector1.size() < 2 || input_vector1.size() > max_table_size_ || input_vector2.size() < 2 || input_vector2.size() > max_table_size_ || rows < 2 || rows > max_table_size_ || cols < 2 || cols > max_table_size_)
     {
         return LookupTable::TableState::size_invalid;
     }
-    else if (input_vector1.size() != input_matrix.rows() || input_vector2.size() != input_matrix.cols())
+    else if (input_vector1.size() != rows || input_vector2.size() != cols)
     {
         return LookupTable::TableState::size_not_match;
     }
@@ -90,17 +127,42 @@ LookupTable::TableState LookupTable2D::CheckTableState(const Eigen::RowVectorXd
     }
 }
 
+// Configurations of lookup methods
+void LookupTable2D::SetInterpMethod(const InterpMethod &method)
+{
+    SetInterpMethod(method, method);
+}
+void LookupTable2D::SetInterpMethod(const InterpMethod &row_method, const InterpMethod &col_method)
+{
+    interp_method_ = row_method;
+    row_interp_method_ = row_method;
+    col_interp_method_ = col_method;
+    BuildSplineSlopes();
+}
+
+void LookupTable2D::SetAxisIndex(const bool &enable)
+{
+    axis_index_enabled_ = enable;
+    row_accelerator_ = table_valid_ ? BuildAxisAccelerator(row_axis_) : AxisAccelerator();
+    col_accelerator_ = table_valid_ ? BuildAxisAccelerator(col_axis_) : AxisAccelerator();
+}
+void LookupTable2D::SetSegmentCoefficients(const bool &enable)
+{
+    segment_coeffs_enabled_ = enable;
+    BuildCellCoefficients();
+}
+
 LookupTable::MatrixIndex LookupTable2D::PreLookup(const double &rvalue, const double &cvalue)
 {
-    std::size_t row = SearchIndex(rvalue, row_axis_, search_method_, prelook_index_.rows());
-    std::size_t col = SearchIndex(cvalue, col_axis_, search_method_, prelook_index_.cols());
+    std::size_t row = SearchAxis(rvalue, row_axis_, row_accelerator_, search_method_, prelook_index_.rows(), row_adaptive_);
+    std::size_t col = SearchAxis(cvalue, col_axis_, col_accelerator_, search_method_, prelook_index_.cols(), col_adaptive_);
     size_t max_row = ConvertSizeDataType(row_axis_.size());
     size_t max_col = ConvertSizeDataType(col_axis_.size());
     if (row >= 0 && row <= max_row && col >= 0 && col <= max_col)
     {
         if (search_method_ != SearchMethod::near)
         {
-            search_method_ = SearchMethod::near; // set to near after binary search
+            search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
         }
         prelook_index_ = {row, col}; // restore prelookup value
     }
@@ -112,7 +174,7 @@ LookupTable::MatrixIndex LookupTable2D::PreLookup(const double &rvalue, const do
 }
 
 // Interpolation between the two closest points
-double LookupTable2D::Interpolation(const MatrixIndex &prelookup_index, const double &rvalue, const double &cvalue)
+double LookupTable2D::Interpolation(const MatrixIndex &prelookup_index, const double &rvalue, const double &cvalue) const
 {
     // Setting calculation range
     const std::size_t &rindex = prelookup_index.rows();
@@ -121,15 +183,197 @@ double LookupTable2D::Interpolation(const MatrixIndex &prelookup_index, const do
     const double &r2 = row_axis_(rindex);
     const double &c1 = col_axis_(cindex - 1);
     const double &c2 = col_axis_(cindex);
-    const double &m11 = map_matrix_(rindex - 1, cindex - 1);
-    const double &m12 = map_matrix_(rindex - 1, cindex);
-    const double &m21 = map_matrix_(rindex, cindex - 1);
-    const double &m22 = map_matrix_(rindex, cindex);
     // Calculate
-    return Interpolate(rvalue, cvalue, r1, r2, c1, c2, m11, m12, m21, m22);
+    if (isSplineMethod(row_interp_method_) || isSplineMethod(col_interp_method_))
+    {
+        return InterpolationSpline(rindex, cindex, Weight(rvalue, r1, r2), Weight(cvalue, c1, c2));
+    }
+    if (cell_coeffs_)
+    {
+        const double *coeffs = cell_coeffs_->segment((rindex - 1) * (table_size_.cols() - 1) + cindex - 1);
+        const double rdelta = rvalue - r1;
+        return coeffs[0] + coeffs[1] * rdelta + (coeffs[2] + coeffs[3] * rdelta) * (cvalue - c1);
+    }
+    return EvaluateCell(rindex, cindex, table_size_.rows(), table_size_.cols(), rvalue, cvalue, row_axis_.data(), col_axis_.data(),
+                        [this](const std::size_t &row, const std::size_t &col) { return map_matrix_(row, col); });
+}
+
+// Tensor product of the per-axis cubic Hermite (spline axes) or linear (other axes) bases over the cell corners
+double LookupTable2D::InterpolationSpline(const std::size_t &rindex, const std::size_t &cindex, const double &rweight, const double &cweight) const
+{
+    const bool row_spline = isSplineMethod(row_interp_method_);
+    const bool col_spline = isSplineMethod(col_interp_method_);
+    double row_value_basis[2], row_slope_basis[2], col_value_basis[2], col_slope_basis[2];
+    HermiteBasis(rweight, row_axis_(rindex) - row_axis_(rindex - 1), row_spline, row_value_basis, row_slope_basis);
+    HermiteBasis(cweight, col_axis_(cindex) - col_axis_(cindex - 1), col_spline, col_value_basis, col_slope_basis);
+    double result = 0;
+    for (std::size_t i = 0; i != 2; ++i)
+    {
+        for (std::size_t j = 0; j != 2; ++j)
+        {
+            const std::size_t row = rindex - 1 + i;
+            const std::size_t col = cindex - 1 + j;
+            result += row_value_basis[i] * col_value_basis[j] * map_matrix_(row, col);
+            result += row_spline ? row_slope_basis[i] * col_value_basis[j] * row_slopes_(row, col) : 0.0;
+            result += col_spline ? row_value_basis[i] * col_slope_basis[j] * col_slopes_(row, col) : 0.0;
+            result += (row_spline && col_spline) ? row_slope_basis[i] * col_slope_basis[j] * cross_slopes_(row, col) : 0.0;
+        }
+    }
+    return result;
+}
+
+// One-dimensional interpolation along a border of the map, used when the other axis is clipped
+double LookupTable2D::InterpolationAlongRow(const std::size_t &rindex, const std::size_t &col, const double &rweight) const
+{
+    const double &y1 = map_matrix_(rindex - 1, col);
+    const double &y2 = map_matrix_(rindex, col);
+    if (!isSplineMethod(row_interp_method_))
+    {
+        return y1 + rweight * (y2 - y1);
+    }
+    double value_basis[2], slope_basis[2];
+    HermiteBasis(rweight, row_axis_(rindex) - row_axis_(rindex - 1), true, value_basis, slope_basis);
+    return value_basis[0] * y1 + value_basis[1] * y2 + slope_basis[0] * row_slopes_(rindex - 1, col) + slope_basis[1] * row_slopes_(rindex, col);
+}
+double LookupTable2D::InterpolationAlongCol(const std::size_t &row, const std::size_t &cindex, const double &cweight) const
+{
+    const double &y1 = map_matrix_(row, cindex - 1);
+    const double &y2 = map_matrix_(row, cindex);
+    if (!isSplineMethod(col_interp_method_))
+    {
+        return y1 + cweight * (y2 - y1);
+    }
+    double value_basis[2], slope_basis[2];
+    HermiteBasis(cweight, col_axis_(cindex) - col_axis_(cindex - 1), true, value_basis, slope_basis);
+    return value_basis[0] * y1 + value_basis[1] * y2 + slope_basis[0] * col_slopes_(row, cindex - 1) + slope_basis[1] * col_slopes_(row, cindex);
+}
+
+void LookupTable2D::BuildSplineSlopes()
+{
+    const bool row_spline = table_valid_ && isSplineMethod(row_interp_method_);
+    const bool col_spline = table_valid_ && isSplineMethod(col_interp_method_);
+    row_slopes_.resize(row_spline ? map_matrix_.rows() : 0, row_spline ? map_matrix_.cols() : 0);
+    col_slopes_.resize(col_spline ? map_matrix_.rows() : 0, col_spline ? map_matrix_.cols() : 0);
+    cross_slopes_.resize(row_spline && col_spline ? map_matrix_.rows() : 0, row_spline && col_spline ? map_matrix_.cols() : 0);
+    for (Eigen::Index col = 0; col < row_slopes_.cols(); ++col)
+    {
+        row_slopes_.col(col) = SplineSlopes(row_axis_, map_matrix_.col(col).transpose(), row_interp_method_).transpose();
+    }
+    for (Eigen::Index row = 0; row < col_slopes_.rows(); ++row)
+    {
+        col_slopes_.row(row) = SplineSlopes(col_axis_, map_matrix_.row(row), col_interp_method_);
+    }
+    for (Eigen::Index col = 0; col < cross_slopes_.cols(); ++col)
+    {
+        cross_slopes_.col(col) = SplineSlopes(row_axis_, col_slopes_.col(col).transpose(), row_interp_method_).transpose();
+    }
+}
+
+void LookupTable2D::BuildCellCoefficients()
+{
+    if (!table_valid_ || !segment_coeffs_enabled_)
+    {
+        cell_coeffs_.reset();
+        return;
+    }
+
+    // Four coefficients per cell fill half a cache line, the corners of the map are no longer read by the lookup
+    const std::size_t rcells = table_size_.rows() - 1;
+    const std::size_t ccells = table_size_.cols() - 1;
+    std::shared_ptr<SegmentCoefficients> coeffs = AllocateSegmentCoefficients(rcells * ccells, 4);
+    for (std::size_t row = 0; row != rcells; ++row)
+    {
+        const double rstep = row_axis_(row + 1) - row_axis_(row);
+        for (std::size_t col = 0; col != ccells; ++col)
+        {
+            const double cstep = col_axis_(col + 1) - col_axis_(col);
+            const double &m11 = map_matrix_(row, col);
+            const double &m12 = map_matrix_(row, col + 1);
+            const double &m21 = map_matrix_(row + 1, col);
+            const double &m22 = map_matrix_(row + 1, col + 1);
+            double *cell = coeffs->storage.data() + coeffs->offset + 4 * (row * ccells + col);
+            cell[0] = m11;
+            cell[1] = (m21 - m11) / rstep;
+            cell[2] = (m12 - m11) / cstep;
+            cell[3] = (m22 - m21 - m12 + m11) / (rstep * cstep);
+        }
+    }
+    cell_coeffs_ = coeffs;
+}
+
+void LookupTable2D::InterpolationBatch(const std::size_t *row_index, const std::size_t *col_index, const double *row_values, const double *col_values, double *results, const std::size_t &count) const
+{
+    // Gather the four corners of every cell, samples to be extrapolated are clamped onto the border cells and patched below
+    const std::size_t rsize = table_size_.rows();
+    const std::size_t csize = table_size_.cols();
+    if (isSplineMethod(row_interp_method_) || isSplineMethod(col_interp_method_))
+    {
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            MatrixIndex index(row_index[i], col_index[i]);
+            bool inside = row_index[i] > 0 && row_index[i] < rsize && col_index[i] > 0 && col_index[i] < csize;
+            results[i] = inside ? Interpolation(index, row_values[i], col_values[i]) : Extrapolation(index, row_values[i], col_values[i]);
+        }
+        return;
+    }
+    BatchArray rv = Eigen::Map<const BatchArray>(row_values, count);
+    BatchArray cv = Eigen::Map<const BatchArray>(col_values, count);
+    if (cell_coeffs_)
+    {
+        // Only the first corner of every cell is read from the axes, the rest comes from the coefficients
+        BatchArray r1(count), c1(count), a(count), b(count), c(count), d(count);
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            std::size_t rindex = std::min(std::max(row_index[i], std::size_t(1)), rsize - 1);
+            std::size_t cindex = std::min(std::max(col_index[i], std::size_t(1)), csize - 1);
+            const double *coeffs = cell_coeffs_->segment((rindex - 1) * (csize - 1) + cindex - 1);
+            r1(i) = row_axis_(rindex - 1);
+            c1(i) = col_axis_(cindex - 1);
+            a(i) = coeffs[0];
+            b(i) = coeffs[1];
+            c(i) = coeffs[2];
+            d(i) = coeffs[3];
+        }
+        BatchArray rdelta = rv - r1;
+        BatchArray output = a + b * rdelta + (c + d * rdelta) * (cv - c1);
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            bool inside = row_index[i] > 0 && row_index[i] < rsize && col_index[i] > 0 && col_index[i] < csize;
+            results[i] = inside ? output(i) : Extrapolation(MatrixIndex(row_index[i], col_index[i]), row_values[i], col_values[i]);
+        }
+        return;
+    }
+    BatchArray r1(count), r2(count), c1(count), c2(count);
+    BatchArray m11(count), m12(count), m21(count), m22(count);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        std::size_t rindex = std::min(std::max(row_index[i], std::size_t(1)), rsize - 1);
+        std::size_t cindex = std::min(std::max(col_index[i], std::size_t(1)), csize - 1);
+        r1(i) = row_axis_(rindex - 1);
+        r2(i) = row_axis_(rindex);
+        c1(i) = col_axis_(cindex - 1);
+        c2(i) = col_axis_(cindex);
+        m11(i) = map_matrix_(rindex - 1, cindex - 1);
+        m21(i) = map_matrix_(rindex, cindex - 1);
+        m12(i) = map_matrix_(rindex - 1, cindex);
+        m22(i) = map_matrix_(rindex, cindex);
+    }
+
+    // Same operations in the same order as Interpolate, so the results match bit for bit
+    BatchArray rdelta = r2 - r1;
+    BatchArray cdelta = c2 - c1;
+    BatchArray rweight = (rdelta.abs() < epsilon_).select(0.5, (rv - r1) / rdelta);
+    BatchArray cweight = (cdelta.abs() < epsilon_).select(0.5, (cv - c1) / cdelta);
+    BatchArray output = (1 - rweight) * ((1 - cweight) * m11 + cweight * m12) + rweight * ((1 - cweight) * m21 + cweight * m22);
+
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        bool inside = row_index[i] > 0 && row_index[i] < rsize && col_index[i] > 0 && col_index[i] < csize;
+        results[i] = inside ? output(i) : Extrapolation(MatrixIndex(row_index[i], col_index[i]), row_values[i], col_values[i]);
+    }
 }
 
-double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const double &rvalue, const double &cvalue)
+double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const double &rvalue, const double &cvalue) const
 {
     // Setting calculation range
     const std::size_t &rindex = prelookup_index.rows();
@@ -137,7 +381,13 @@ double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const do
     const std::size_t rsize = table_size_.rows();
     const std::size_t csize = table_size_.cols();
     double result = 0;
+    if (!isSplineMethod(row_interp_method_) && !isSplineMethod(col_interp_method_))
+    {
+        return EvaluateCell(rindex, cindex, rsize, csize, rvalue, cvalue, row_axis_.data(), col_axis_.data(),
+                            [this](const std::size_t &row, const std::size_t &col) { return map_matrix_(row, col); });
+    }
 
+    // Spline axes interpolate along the border with their slopes
     if (rindex < 1)
     {
         if (cindex < 1)
@@ -151,7 +401,7 @@ double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const do
         else
         {
             // Interpolate 1D
-            result = Interpolate(cvalue, col_axis_(cindex - 1), col_axis_(cindex), map_matrix_(0, cindex - 1), map_matrix_(0, cindex));
+            result = InterpolationAlongCol(0, cindex, Weight(cvalue, col_axis_(cindex - 1), col_axis_(cindex)));
         }
     }
     else if (rindex >= rsize)
@@ -167,7 +417,7 @@ double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const do
         else
         {
             // Interpolate 1D
-            result = Interpolate(cvalue, col_axis_(cindex - 1), col_axis_(cindex), map_matrix_(rsize - 1, cindex - 1), map_matrix_(rsize - 1, cindex));
+            result = InterpolationAlongCol(rsize - 1, cindex, Weight(cvalue, col_axis_(cindex - 1), col_axis_(cindex)));
         }
     }
     else
@@ -175,12 +425,12 @@ double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const do
         if (cindex < 1)
         {
             // Interpolate 1D
-            result = Interpolate(rvalue, row_axis_(rindex - 1), row_axis_(rindex - 1), map_matrix_(rindex - 1, 0), map_matrix_(rindex, 0));
+            result = InterpolationAlongRow(rindex, 0, Weight(rvalue, row_axis_(rindex - 1), row_axis_(rindex)));
         }
         else if (cindex >= csize)
         {
             // Interpolate 1D
-            result = Interpolate(rvalue, row_axis_(rindex - 1), row_axis_(rindex), map_matrix_(rindex - 1, csize - 1), map_matrix_(rindex, csize - 1));
+            result = InterpolationAlongRow(rindex, csize - 1, Weight(rvalue, row_axis_(rindex - 1), row_axis_(rindex)));
         }
     }
     return result;
@@ -189,6 +439,7 @@ double LookupTable2D::Extrapolation(const MatrixIndex &prelookup_index, const do
 // Lookup table based on input, using current search, interp, and extrap methods
 double LookupTable2D::Lookup(const double &rvalue, const double &cvalue)
 {
+    LookupTimer timer = StartLookupTimer();
     if (table_valid_)
     {
         MatrixIndex matrix_index = PreLookup(rvalue, cvalue);
@@ -211,3 +462,393 @@ double LookupTable2D::Lookup(const double &rvalue, const double &cvalue)
     }
     return lookup_result_;
 }
+
+// Batch lookup, each axis is searched as a block before the cells are interpolated together
+void LookupTable2D::LookupBatch(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, const SearchMethod &first_method,
+                                std::size_t &row, std::size_t &col, AdaptiveState &row_adaptive, AdaptiveState &col_adaptive) const
+{
+    CountLookups(count);
+    std::size_t row_block[batch_block_size_];
+    std::size_t col_block[batch_block_size_];
+    const SearchMethod next_method = NextSearchMethod(first_method);
+    row = SearchAxis(rvalues[0], row_axis_, row_accelerator_, first_method, row, row_adaptive); // the first pair uses the given method, then near search
+    col = SearchAxis(cvalues[0], col_axis_, col_accelerator_, first_method, col, col_adaptive);
+    for (std::size_t start = 0; start < count; start += batch_block_size_)
+    {
+        const std::size_t block = (count - start < batch_block_size_) ? count - start : batch_block_size_;
+        for (std::size_t i = 0; i != block; ++i)
+        {
+            row = (start + i == 0) ? row : SearchAxis(rvalues[start + i], row_axis_, row_accelerator_, next_method, row, row_adaptive);
+            row_block[i] = row;
+        }
+        for (std::size_t i = 0; i != block; ++i)
+        {
+            col = (start + i == 0) ? col : SearchAxis(cvalues[start + i], col_axis_, col_accelerator_, next_method, col, col_adaptive);
+            col_block[i] = col;
+        }
+        InterpolationBatch(row_block, col_block, rvalues + start, cvalues + start, results + start, block);
+    }
+}
+void LookupTable2D::Lookup(const double *rvalues, const double *cvalues, double *results, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        return;
+    }
+
+    std::size_t row = prelook_index_.rows();
+    std::size_t col = prelook_index_.cols();
+    LookupBatch(rvalues, cvalues, results, count, search_method_, row, col, row_adaptive_, col_adaptive_);
+    search_method_ = NextSearchMethod(search_method_); // same as PreLookup after a valid search
+    prelook_index_ = {row, col};
+    lookup_result_ = results[count - 1];
+}
+void LookupTable2D::Lookup(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results)
+{
+    std::size_t count = std::min(rvalues.size(), cvalues.size());
+    results.resize(count);
+    Lookup(rvalues.data(), cvalues.data(), results.data(), count);
+}
+void LookupTable2D::Lookup(const Eigen::Ref<const Eigen::RowVectorXd> &rvalues, const Eigen::Ref<const Eigen::RowVectorXd> &cvalues, Eigen::Ref<Eigen::RowVectorXd> results)
+{
+    std::size_t count = ConvertSizeDataType(std::min(std::min(rvalues.size(), cvalues.size()), results.size()));
+    Lookup(rvalues.data(), cvalues.data(), results.data(), count);
+}
+
+// Thread-safe lookup, only the cursor is written
+double LookupTable2D::Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        SearchMethod method = cursor.primed ? NextSearchMethod(search_method_) : search_method_;
+        MatrixIndex matrix_index(SearchAxis(rvalue, row_axis_, row_accelerator_, method, cursor.row_index, cursor.row_adaptive),
+                                 SearchAxis(cvalue, col_axis_, col_accelerator_, method, cursor.col_index, cursor.col_adaptive));
+        cursor.row_index = matrix_index.rows();
+        cursor.col_index = matrix_index.cols();
+        cursor.primed = true;
+        bool inside = cursor.row_index > 0 && cursor.row_index < table_size_.rows() && cursor.col_index > 0 && cursor.col_index < table_size_.cols();
+        cursor.result = inside ? Interpolation(matrix_index, rvalue, cvalue) : Extrapolation(matrix_index, rvalue, cvalue);
+    }
+    return cursor.result;
+}
+void LookupTable2D::Lookup(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, LookupCursor &cursor) const
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        std::fill(results, results + count, cursor.result);
+        return;
+    }
+
+    LookupBatch(rvalues, cvalues, results, count, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index, cursor.col_index, cursor.row_adaptive, cursor.col_adaptive);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+void LookupTable2D::Lookup(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results, LookupCursor &cursor) const
+{
+    std::size_t count = std::min(rvalues.size(), cvalues.size());
+    results.resize(count);
+    Lookup(rvalues.data(), cvalues.data(), results.data(), count, cursor);
+}
+
+// Interpolation with shared prelookups, clip on the axes that are out of range like Extrapolation
+double LookupTable2D::Lookup(const PrelookupResult &row_prelookup, const PrelookupResult &col_prelookup) const
+{
+    LookupTimer timer = StartLookupTimer();
+    const std::size_t rsize = table_size_.rows();
+    const std::size_t csize = table_size_.cols();
+    const std::size_t &rindex = row_prelookup.index;
+    const std::size_t &cindex = col_prelookup.index;
+    if (!table_valid_ || rindex > rsize || cindex > csize)
+    {
+        return lookup_result_; // invalid table or prelookup from a different axis, keep last value
+    }
+    const double &rweight = row_prelookup.fraction;
+    const double &cweight = col_prelookup.fraction;
+    const bool row_inside = rindex > 0 && rindex < rsize;
+    const bool col_inside = cindex > 0 && cindex < csize;
+    if (row_inside && col_inside && (isSplineMethod(row_interp_method_) || isSplineMethod(col_interp_method_)))
+    {
+        return InterpolationSpline(rindex, cindex, rweight, cweight);
+    }
+    else if (row_inside && col_inside)
+    {
+        const double &m11 = map_matrix_(rindex - 1, cindex - 1);
+        const double &m12 = map_matrix_(rindex - 1, cindex);
+        const double &m21 = map_matrix_(rindex, cindex - 1);
+        const double &m22 = map_matrix_(rindex, cindex);
+        return (1 - rweight) * ((1 - cweight) * m11 + cweight * m12) + rweight * ((1 - cweight) * m21 + cweight * m22);
+    }
+    else if (!row_inside && !col_inside)
+    {
+        return map_matrix_(rindex < 1 ? 0 : rsize - 1, cindex < 1 ? 0 : csize - 1);
+    }
+    else if (!row_inside)
+    {
+        return InterpolationAlongCol(rindex < 1 ? 0 : rsize - 1, cindex, cweight);
+    }
+    else
+    {
+        return InterpolationAlongRow(rindex, cindex < 1 ? 0 : csize - 1, rweight);
+    }
+}
+
+
+// Inverse lookup along the columns, a convex combination of two rows that are monotone in the same direction is
+// monotone as well, so the interpolated row can be searched like an axis
+void LookupTable2D::BuildInverse()
+{
+    col_monotonicity_ = table_valid_ ? CheckMonotonicity(map_matrix_.row(0)) : Monotonicity::none;
+    for (Eigen::Index row = 1; row < map_matrix_.rows() && col_monotonicity_ != Monotonicity::none; ++row)
+    {
+        col_monotonicity_ = CheckMonotonicity(map_matrix_.row(row)) == col_monotonicity_ ? col_monotonicity_ : Monotonicity::none;
+    }
+    inverse_primed_ = false;
+}
+double LookupTable2D::InverseAlongCol(const std::size_t &rindex, const double &rvalue, const double &zvalue, std::size_t &cindex) const
+{
+    // Rows around the value, the end row alone when the row value is clipped
+    const std::size_t rsize = table_size_.rows();
+    const std::size_t csize = table_size_.cols();
+    const std::size_t row1 = rindex == 0 ? 0 : std::min(rindex, rsize) - 1;
+    const std::size_t row2 = std::min(rindex, rsize - 1);
+    const double rweight = row1 == row2 ? 0.0 : Weight(rvalue, row_axis_(row1), row_axis_(row2));
+    const double sign = col_monotonicity_ == Monotonicity::increasing ? 1.0 : -1.0;
+    auto value = [&](const std::size_t &col)
+    { return (1 - rweight) * map_matrix_(row1, col) + rweight * map_matrix_(row2, col); };
+
+    // First column whose value is not below zvalue in the direction of the rows, same convention as SearchIndex
+    std::size_t first = 0;
+    std::size_t last = csize;
+    while (first < last)
+    {
+        const std::size_t middle = first + (last - first) / 2;
+        if (sign * value(middle) < sign * zvalue)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    cindex = first;
+    if (cindex == 0 || cindex == csize)
+    {
+        return cindex == 0 ? col_axis_(0) : col_axis_(csize - 1);
+    }
+    return Interpolate(zvalue, value(cindex - 1), value(cindex), col_axis_(cindex - 1), col_axis_(cindex));
+}
+double LookupTable2D::InverseLookup(const double &rvalue, const double &zvalue)
+{
+    if (col_monotonicity_ != Monotonicity::none)
+    {
+        const SearchMethod method = inverse_primed_ ? NextSearchMethod(search_method_) : search_method_;
+        inverse_row_ = SearchAxis(rvalue, row_axis_, row_accelerator_, method, inverse_row_, inverse_adaptive_);
+        inverse_primed_ = true;
+        std::size_t cindex = 0;
+        inverse_result_ = InverseAlongCol(inverse_row_, rvalue, zvalue, cindex);
+    }
+    return inverse_result_;
+}
+double LookupTable2D::InverseLookup(const double &rvalue, const double &zvalue, LookupCursor &cursor) const
+{
+    if (col_monotonicity_ != Monotonicity::none)
+    {
+        const SearchMethod method = cursor.primed ? NextSearchMethod(search_method_) : search_method_;
+        cursor.row_index = SearchAxis(rvalue, row_axis_, row_accelerator_, method, cursor.row_index, cursor.row_adaptive);
+        cursor.primed = true;
+        cursor.result = InverseAlongCol(cursor.row_index, rvalue, zvalue, cursor.col_index);
+    }
+    return cursor.result;
+}
+
+// Partial derivatives of the tensor product in InterpolationSpline, with linear bases on the linear axes. A clipped
+// axis sits on its end breakpoint with a zero derivative basis, which matches Extrapolation.
+void LookupTable2D::Gradient(const MatrixIndex &prelookup_index, const double &rvalue, const double &cvalue, double &row_derivative, double &col_derivative) const
+{
+    const std::size_t rsize = table_size_.rows();
+    const std::size_t csize = table_size_.cols();
+    const bool row_inside = prelookup_index.rows() > 0 && prelookup_index.rows() < rsize;
+    const bool col_inside = prelookup_index.cols() > 0 && prelookup_index.cols() < csize;
+    const std::size_t rindex = std::min(std::max(prelookup_index.rows(), std::size_t(1)), rsize - 1);
+    const std::size_t cindex = std::min(std::max(prelookup_index.cols(), std::size_t(1)), csize - 1);
+    const double rstep = row_axis_(rindex) - row_axis_(rindex - 1);
+    const double cstep = col_axis_(cindex) - col_axis_(cindex - 1);
+    const double rweight = row_inside ? Weight(rvalue, row_axis_(rindex - 1), row_axis_(rindex)) : (prelookup_index.rows() == 0 ? 0.0 : 1.0);
+    const double cweight = col_inside ? Weight(cvalue, col_axis_(cindex - 1), col_axis_(cindex)) : (prelookup_index.cols() == 0 ? 0.0 : 1.0);
+
+    const bool row_spline = isSplineMethod(row_interp_method_);
+    const bool col_spline = isSplineMethod(col_interp_method_);
+    double row_value_basis[2], row_slope_basis[2], col_value_basis[2], col_slope_basis[2];
+    double row_value_derivative[2] = {0, 0}, row_slope_derivative[2] = {0, 0}, col_value_derivative[2] = {0, 0}, col_slope_derivative[2] = {0, 0};
+    HermiteBasis(rweight, rstep, row_spline, row_value_basis, row_slope_basis);
+    HermiteBasis(cweight, cstep, col_spline, col_value_basis, col_slope_basis);
+    if (row_inside)
+    {
+        HermiteBasisDerivative(rweight, rstep, row_spline, row_value_derivative, row_slope_derivative);
+    }
+    if (col_inside)
+    {
+        HermiteBasisDerivative(cweight, cstep, col_spline, col_value_derivative, col_slope_derivative);
+    }
+
+    row_derivative = 0;
+    col_derivative = 0;
+    for (std::size_t i = 0; i != 2; ++i)
+    {
+        for (std::size_t j = 0; j != 2; ++j)
+        {
+            const std::size_t row = rindex - 1 + i;
+            const std::size_t col = cindex - 1 + j;
+            const double value = map_matrix_(row, col);
+            const double row_slope = row_spline ? row_slopes_(row, col) : 0.0;
+            const double col_slope = col_spline ? col_slopes_(row, col) : 0.0;
+            const double cross_slope = (row_spline && col_spline) ? cross_slopes_(row, col) : 0.0;
+            row_derivative += row_value_derivative[i] * (col_value_basis[j] * value + col_slope_basis[j] * col_slope) +
+                              row_slope_derivative[i] * (col_value_basis[j] * row_slope + col_slope_basis[j] * cross_slope);
+            col_derivative += col_value_derivative[j] * (row_value_basis[i] * value + row_slope_basis[i] * row_slope) +
+                              col_slope_derivative[j] * (row_value_basis[i] * col_slope + row_slope_basis[i] * cross_slope);
+        }
+    }
+}
+void LookupTable2D::LookupGradientBatch(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count,
+                                        const SearchMethod &first_method, std::size_t &row, std::size_t &col, AdaptiveState &row_adaptive, AdaptiveState &col_adaptive) const
+{
+    CountLookups(count);
+    const SearchMethod next_method = NextSearchMethod(first_method);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        row = SearchAxis(rvalues[i], row_axis_, row_accelerator_, i == 0 ? first_method : next_method, row, row_adaptive);
+        col = SearchAxis(cvalues[i], col_axis_, col_accelerator_, i == 0 ? first_method : next_method, col, col_adaptive);
+        const MatrixIndex index(row, col);
+        const bool inside = row > 0 && row < table_size_.rows() && col > 0 && col < table_size_.cols();
+        results[i] = inside ? Interpolation(index, rvalues[i], cvalues[i]) : Extrapolation(index, rvalues[i], cvalues[i]);
+        Gradient(index, rvalues[i], cvalues[i], row_derivatives[i], col_derivatives[i]);
+    }
+}
+double LookupTable2D::LookupGradient(const double &rvalue, const double &cvalue, double &row_derivative, double &col_derivative)
+{
+    LookupGradient(&rvalue, &cvalue, &lookup_result_, &row_derivative, &col_derivative, 1);
+    return lookup_result_;
+}
+double LookupTable2D::LookupGradient(const double &rvalue, const double &cvalue, double &row_derivative, double &col_derivative, LookupCursor &cursor) const
+{
+    LookupGradient(&rvalue, &cvalue, &cursor.result, &row_derivative, &col_derivative, 1, cursor);
+    return cursor.result;
+}
+void LookupTable2D::LookupGradient(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        std::fill(row_derivatives, row_derivatives + count, 0.0);
+        std::fill(col_derivatives, col_derivatives + count, 0.0);
+        return;
+    }
+
+    std::size_t row = prelook_index_.rows();
+    std::size_t col = prelook_index_.cols();
+    LookupGradientBatch(rvalues, cvalues, results, row_derivatives, col_derivatives, count, search_method_, row, col, row_adaptive_, col_adaptive_);
+    search_method_ = NextSearchMethod(search_method_);
+    prelook_index_ = {row, col};
+    lookup_result_ = results[count - 1];
+}
+void LookupTable2D::LookupGradient(const double *rvalues, const double *cvalues, double *results, double *row_derivatives, double *col_derivatives, const std::size_t &count, LookupCursor &cursor) const
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        std::fill(results, results + count, cursor.result);
+        std::fill(row_derivatives, row_derivatives + count, 0.0);
+        std::fill(col_derivatives, col_derivatives + count, 0.0);
+        return;
+    }
+
+    LookupGradientBatch(rvalues, cvalues, results, row_derivatives, col_derivatives, count, cursor.primed ? NextSearchMethod(search_method_) : search_method_,
+                        cursor.row_index, cursor.col_index, cursor.row_adaptive, cursor.col_adaptive);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+
+// Sorted lookup, the merge passes replace the searches, interpolation runs on blocks like the batch lookup
+void LookupTable2D::LookupMergeBatch(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, std::size_t &row, std::size_t &col) const
+{
+    CountLookups(count);
+    std::size_t row_block[batch_block_size_];
+    std::size_t col_block[batch_block_size_];
+    for (std::size_t start = 0; start < count; start += batch_block_size_)
+    {
+        const std::size_t block = (count - start < batch_block_size_) ? count - start : batch_block_size_;
+        for (std::size_t i = 0; i != block; ++i)
+        {
+            row = SearchMerge(rvalues[start + i], row_axis_.data(), table_size_.rows(), row);
+            row_block[i] = row;
+        }
+        for (std::size_t i = 0; i != block; ++i)
+        {
+            col = SearchMerge(cvalues[start + i], col_axis_.data(), table_size_.cols(), col);
+            col_block[i] = col;
+        }
+        InterpolationBatch(row_block, col_block, rvalues + start, cvalues + start, results + start, block);
+    }
+}
+void LookupTable2D::LookupSorted(const double *rvalues, const double *cvalues, double *results, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        return;
+    }
+
+    std::size_t row = prelook_index_.rows();
+    std::size_t col = prelook_index_.cols();
+    LookupMergeBatch(rvalues, cvalues, results, count, row, col);
+    prelook_index_ = {row, col};
+    lookup_result_ = results[count - 1];
+}
+void LookupTable2D::LookupSorted(const double *rvalues, const double *cvalues, double *results, const std::size_t &count, LookupCursor &cursor) const
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        std::fill(results, results + count, cursor.result);
+        return;
+    }
+
+    LookupMergeBatch(rvalues, cvalues, results, count, cursor.row_index, cursor.col_index);
+    cursor.primed = true;
+    cursor.result = results[count - 1];
+}
+void LookupTable2D::LookupSorted(const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results, LookupCursor &cursor) const
+{
+    std::size_t count = std::min(rvalues.size(), cvalues.size());
+    results.resize(count);
+    LookupSorted(rvalues.data(), cvalues.data(), results.data(), count, cursor);
+}
@@ -0,0 +1,184 @@
+#include "lookup_table_view.h"
+
+// One-dimensional view
+LookupTable::AssignmentState LookupTable1DView::AttachTableData(const double *x_axis, const double *y_table, const std::size_t &size)
+{
+    if (x_axis == nullptr || y_table == nullptr || size == 0)
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    else if (size < 2 || size > max_table_size_ || !isStrictlyIncreasing(AxisMap(x_axis, size)))
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    Attach(x_axis, y_table, size, BuildAxisAccelerator(AxisMap(x_axis, size)));
+    return AssignmentState::success;
+}
+
+void LookupTable1DView::Attach(const double *x_axis, const double *y_table, const std::size_t &size, const AxisAccelerator &x_accelerator)
+{
+    x_axis_ = x_axis;
+    y_table_ = y_table;
+    table_size_ = size;
+    prelook_index_ = 0;
+    x_accelerator_ = x_accelerator;
+    lower_extrap_value_specify_ = y_table_[0];
+    upper_extrap_value_specify_ = y_table_[table_size_ - 1];
+    table_empty_ = false;
+    table_state_ = TableState::valid;
+    RefreshValid();
+}
+
+bool LookupTable1DView::ClearTable()
+{
+    x_axis_ = nullptr;
+    y_table_ = nullptr;
+    table_size_ = 0;
+    x_accelerator_ = AxisAccelerator();
+    table_valid_ = false;
+    table_empty_ = true;
+    table_state_ = TableState::empty;
+    return true;
+}
+
+void LookupTable1DView::SetInterpMethod(const InterpMethod &method)
+{
+    interp_method_ = method;
+    RefreshValid();
+}
+
+void LookupTable1DView::SetExtrapMethod(const ExtrapMethod &method, const double &lower_value, const double &upper_value)
+{
+    extrap_method_ = method;
+    lower_extrap_value_specify_ = lower_value;
+    upper_extrap_value_specify_ = upper_value;
+}
+
+double LookupTable1DView::Evaluate(const std::size_t &index, const double &xvalue, const double &fallback) const
+{
+    double result = fallback;
+    EvaluateSegment(index, table_size_, xvalue, x_axis_, [this](const std::size_t &i) { return y_table_[i]; }, lower_extrap_value_specify_, upper_extrap_value_specify_, result);
+    return result;
+}
+
+double LookupTable1DView::Lookup(const double &xvalue)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        prelook_index_ = SearchAxis(xvalue, x_axis(), x_accelerator_, search_method_, prelook_index_);
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        lookup_result_ = Evaluate(prelook_index_, xvalue, lookup_result_);
+    }
+    return lookup_result_;
+}
+double LookupTable1DView::Lookup(const double &xvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        cursor.row_index = SearchAxis(xvalue, x_axis(), x_accelerator_, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index);
+        cursor.primed = true;
+        cursor.result = Evaluate(cursor.row_index, xvalue, cursor.result);
+    }
+    return cursor.result;
+}
+
+// Two-dimensional view
+LookupTable::AssignmentState LookupTable2DView::AttachTableData(const double *row_axis, const double *col_axis, const double *map_data, const std::size_t &rows, const std::size_t &cols,
+                                                                const Layout &layout)
+{
+    if (row_axis == nullptr || col_axis == nullptr || map_data == nullptr)
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    else if (rows < 2 || rows > max_table_size_ || cols < 2 || cols > max_table_size_)
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    else if (!isStrictlyIncreasing(AxisMap(row_axis, rows)) || !isStrictlyIncreasing(AxisMap(col_axis, cols)))
+    {
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+    Attach(row_axis, col_axis, map_data, rows, cols, BuildAxisAccelerator(AxisMap(row_axis, rows)), BuildAxisAccelerator(AxisMap(col_axis, cols)), layout);
+    return AssignmentState::success;
+}
+
+void LookupTable2DView::Attach(const double *row_axis, const double *col_axis, const double *map_data, const std::size_t &rows, const std::size_t &cols,
+                               const AxisAccelerator &row_accelerator, const AxisAccelerator &col_accelerator, const Layout &layout)
+{
+    row_axis_ = row_axis;
+    col_axis_ = col_axis;
+    map_data_ = map_data;
+    table_size_ = {rows, cols};
+    layout_ = layout;
+    row_stride_ = layout == Layout::row_major ? cols : 1;
+    col_stride_ = layout == Layout::row_major ? 1 : rows;
+    prelook_index_ = {0, 0};
+    row_accelerator_ = row_accelerator;
+    col_accelerator_ = col_accelerator;
+    table_empty_ = false;
+    table_state_ = TableState::valid;
+    RefreshValid();
+}
+
+bool LookupTable2DView::ClearTable()
+{
+    row_axis_ = nullptr;
+    col_axis_ = nullptr;
+    map_data_ = nullptr;
+    table_size_ = {0, 0};
+    row_stride_ = 0;
+    col_stride_ = 0;
+    row_accelerator_ = AxisAccelerator();
+    col_accelerator_ = AxisAccelerator();
+    table_valid_ = false;
+    table_empty_ = true;
+    table_state_ = TableState::empty;
+    return true;
+}
+
+void LookupTable2DView::SetInterpMethod(const InterpMethod &method)
+{
+    SetInterpMethod(method, method);
+}
+void LookupTable2DView::SetInterpMethod(const InterpMethod &row_method, const InterpMethod &col_method)
+{
+    interp_method_ = row_method;
+    row_interp_method_ = row_method;
+    col_interp_method_ = col_method;
+    RefreshValid();
+}
+
+double LookupTable2DView::Evaluate(const std::size_t &rindex, const std::size_t &cindex, const double &rvalue, const double &cvalue) const
+{
+    return EvaluateCell(rindex, cindex, table_size_.rows(), table_size_.cols(), rvalue, cvalue, row_axis_, col_axis_,
+                        [this](const std::size_t &row, const std::size_t &col) { return Value(row, col); });
+}
+
+double LookupTable2DView::Lookup(const double &rvalue, const double &cvalue)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        std::size_t row = SearchAxis(rvalue, row_axis(), row_accelerator_, search_method_, prelook_index_.rows());
+        std::size_t col = SearchAxis(cvalue, col_axis(), col_accelerator_, search_method_, prelook_index_.cols());
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        prelook_index_ = {row, col};
+        lookup_result_ = Evaluate(row, col, rvalue, cvalue);
+    }
+    return lookup_result_;
+}
+double LookupTable2DView::Lookup(const double &rvalue, const double &cvalue, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        SearchMethod method = cursor.primed ? NextSearchMethod(search_method_) : search_method_;
+        cursor.row_index = SearchAxis(rvalue, row_axis(), row_accelerator_, method, cursor.row_index);
+        cursor.col_index = SearchAxis(cvalue, col_axis(), col_accelerator_, method, cursor.col_index);
+        cursor.primed = true;
+        cursor.result = Evaluate(cursor.row_index, cursor.col_index, rvalue, cvalue);
+    }
+    return cursor.result;
+}
@@ -0,0 +1,248 @@
+#include "lookup_tablend.h"
+
+constexpr std::size_t LookupTableND::max_dimensions_;
+
+// Assign table data with new input values, validate first.
+LookupTable::AssignmentState LookupTableND::AssignTableData(const std::vector<Eigen::RowVectorXd> &axes, const Eigen::VectorXd &data)
+{
+    if (CheckTableState(axes, data) == TableState::valid)
+    {
+        axes_ = axes;
+        data_ = data;
+        bool refresh = RefreshTableState(); // redundant check, and refresh state in table
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+}
+LookupTable::AssignmentState LookupTableND::AssignTableData(const std::vector<std::vector<double>> &axes, const std::vector<double> &data)
+{
+    // this is vector edition, first convert then call the base AssignTableData function.
+    std::vector<Eigen::RowVectorXd> axes_eigen;
+    for (const auto &axis : axes)
+    {
+        axes_eigen.push_back(Eigen::Map<const Eigen::RowVectorXd>(axis.data(), axis.size()));
+    }
+    Eigen::VectorXd data_eigen = Eigen::Map<const Eigen::VectorXd>(data.data(), data.size());
+    return AssignTableData(axes_eigen, data_eigen);
+}
+
+bool LookupTableND::ClearTable()
+{
+    axes_.clear();
+    data_.resize(0);
+    bool refresh = RefreshTableState(); // resets the state to empty
+    return true;
+}
+
+bool LookupTableND::RefreshTableState()
+{
+    table_state_ = CheckTableState(axes_, data_);
+    const std::size_t dims = axes_.size();
+    table_size_.resize(dims);
+    strides_.resize(dims);
+    accelerators_.resize(dims);
+    prelook_index_.resize(dims, 0);
+    extrap_methods_.resize(dims, extrap_method_);
+    std::size_t stride = 1;
+    for (std::size_t axis = dims; axis-- > 0;)
+    {
+        table_size_[axis] = ConvertSizeDataType(axes_[axis].size());
+        strides_[axis] = stride;
+        stride *= table_size_[axis];
+    }
+    if (table_state_ == TableState::valid)
+    {
+        table_valid_ = true;
+        table_empty_ = false;
+        for (std::size_t axis = 0; axis != dims; ++axis)
+        {
+            accelerators_[axis] = BuildAxisAccelerator(axes_[axis]);
+        }
+    }
+    else
+    {
+        table_valid_ = false;
+        table_empty_ = table_state_ == TableState::empty;
+        std::fill(accelerators_.begin(), accelerators_.end(), AxisAccelerator());
+    }
+    return table_valid_;
+}
+
+LookupTable::TableState LookupTableND::CheckTableState(const std::vector<Eigen::RowVectorXd> &axes, const Eigen::VectorXd &data)
+{
+    if (axes.empty() && data.size() == 0)
+    {
+        return TableState::empty;
+    }
+    else if (axes.empty() || axes.size() > max_dimensions_)
+    {
+        return TableState::size_invalid; // number of axes must be within the range [1 max_dimensions]
+    }
+    std::size_t elements = 1;
+    for (const auto &axis : axes)
+    {
+        if (axis.size() < 2 || axis.size() > max_table_size_)
+        {
+            return TableState::size_invalid; // every axis size must be within the range [2 max_axis_size]
+        }
+        elements *= ConvertSizeDataType(axis.size());
+        if (elements > ConvertSizeDataType(data.size()))
+        {
+            return TableState::size_not_match; // stop early, also avoids overflow of the product
+        }
+    }
+    if (elements != ConvertSizeDataType(data.size()))
+    {
+        return TableState::size_not_match; // data size must be the product of the axis sizes
+    }
+    for (const auto &axis : axes)
+    {
+        if (!isStrictlyIncreasing(axis))
+        {
+            return TableState::axis_not_increase;
+        }
+    }
+    return TableState::valid;
+}
+
+// Configurations of lookup methods
+void LookupTableND::SetInterpMethod(const InterpMethod &)
+{
+    interp_method_ = InterpMethod::linear; // only multilinear interpolation is implemented
+}
+void LookupTableND::SetExtrapMethod(const ExtrapMethod &method)
+{
+    extrap_method_ = method;
+    std::fill(extrap_methods_.begin(), extrap_methods_.end(), method);
+}
+void LookupTableND::SetExtrapMethod(const std::size_t &axis, const ExtrapMethod &method)
+{
+    if (axis < extrap_methods_.size())
+    {
+        extrap_methods_[axis] = method;
+    }
+}
+
+// Prelook
+void LookupTableND::PreLookup(const double *values, const SearchMethod &method)
+{
+    for (std::size_t axis = 0; axis != axes_.size(); ++axis)
+    {
+        prelook_index_[axis] = SearchAxis(values[axis], axes_[axis], accelerators_[axis], method, prelook_index_[axis]);
+    }
+}
+
+double LookupTableND::Interpolation(const std::size_t *index, const double *values) const
+{
+    const std::size_t dims = axes_.size();
+    double weight[max_dimensions_];
+    double corners[std::size_t(1) << max_dimensions_];
+    std::size_t base = 0;
+
+    // Segment and weight on every axis, clip holds the weight at the border, linear keeps the raw weight
+    for (std::size_t axis = 0; axis != dims; ++axis)
+    {
+        const Eigen::RowVectorXd &axis_data = axes_[axis];
+        const std::size_t size = table_size_[axis];
+        const std::size_t segment = std::min(std::max(index[axis], std::size_t(1)), size - 1);
+        const double x1 = axis_data(segment - 1);
+        const double x2 = axis_data(segment);
+        if ((index[axis] == 0 || index[axis] == size) && extrap_methods_[axis] != ExtrapMethod::linear)
+        {
+            weight[axis] = index[axis] == 0 ? 0.0 : 1.0;
+        }
+        else
+        {
+            bool equal_zero = std::abs(x2 - x1) < epsilon_;
+            weight[axis] = equal_zero ? 0.5 : (values[axis] - x1) / (x2 - x1);
+        }
+        base += (segment - 1) * strides_[axis];
+    }
+
+    // Gather the corners, bit k of the corner number selects the upper breakpoint of axis k
+    const std::size_t corner_count = std::size_t(1) << dims;
+    for (std::size_t corner = 0; corner != corner_count; ++corner)
+    {
+        std::size_t offset = base;
+        for (std::size_t axis = 0; axis != dims; ++axis)
+        {
+            offset += ((corner >> axis) & 1U) * strides_[axis];
+        }
+        corners[corner] = data_(offset);
+    }
+
+    // Collapse one axis at a time, 2^N - 1 linear interpolations in total
+    for (std::size_t axis = 0, remaining = corner_count; axis != dims; ++axis)
+    {
+        remaining /= 2;
+        for (std::size_t corner = 0; corner != remaining; ++corner)
+        {
+            const double y1 = corners[2 * corner];
+            const double y2 = corners[2 * corner + 1];
+            corners[corner] = y1 + weight[axis] * (y2 - y1);
+        }
+    }
+    return corners[0];
+}
+
+// Final function LookupTable
+double LookupTableND::Lookup(const double *values)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        PreLookup(values, search_method_);
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        lookup_result_ = Interpolation(prelook_index_.data(), values);
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+    }
+    return lookup_result_;
+}
+double LookupTableND::Lookup(const std::vector<double> &values)
+{
+    if (values.size() < axes_.size())
+    {
+        return lookup_result_; // not enough inputs, keep last value
+    }
+    return Lookup(values.data());
+}
+
+// Batch lookup, the search method is resolved once for the whole batch
+void LookupTableND::Lookup(const double *points, double *results, const std::size_t &count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!table_valid_)
+    {
+        bool refresh = RefreshTableState();
+        std::fill(results, results + count, lookup_result_);
+        return;
+    }
+
+    CountLookups(count);
+    const std::size_t dims = axes_.size();
+    PreLookup(points, search_method_);
+    results[0] = Interpolation(prelook_index_.data(), points);
+    for (std::size_t point = 1; point != count; ++point)
+    {
+        PreLookup(points + point * dims, NextSearchMethod(search_method_));
+        results[point] = Interpolation(prelook_index_.data(), points + point * dims);
+    }
+    search_method_ = NextSearchMethod(search_method_);
+    lookup_result_ = results[count - 1];
+}
+void LookupTableND::Lookup(const std::vector<double> &points, std::vector<double> &results)
+{
+    const std::size_t count = axes_.empty() ? 0 : points.size() / axes_.size();
+    results.resize(count);
+    Lookup(points.data(), results.data(), count);
+}
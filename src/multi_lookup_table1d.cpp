@@ -0,0 +1,134 @@
+#include "multi_lookup_table1d.h"
+
+// Assign table data with new input values, validate first.
+LookupTable::AssignmentState MultiLookupTable1D::AssignTableData(const Eigen::RowVectorXd &x_axis, const Eigen::MatrixXd &y_table)
+{
+    if (CheckTableState(x_axis, y_table) == TableState::valid)
+    {
+        x_axis_ = x_axis;
+        y_table_ = y_table;
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+}
+
+bool MultiLookupTable1D::ClearTable()
+{
+    x_axis_.resize(0);
+    y_table_.resize(0, 0);
+    table_valid_ = false;
+    table_empty_ = true;
+    table_size_ = 0;
+    table_state_ = TableState::empty;
+    x_accelerator_ = AxisAccelerator();
+    return true;
+}
+
+bool MultiLookupTable1D::RefreshTableState()
+{
+    table_state_ = CheckTableState(x_axis_, y_table_);
+    table_valid_ = table_state_ == TableState::valid;
+    table_empty_ = table_state_ == TableState::empty;
+    table_size_ = table_valid_ ? ConvertSizeDataType(x_axis_.size()) : 0U;
+    x_accelerator_ = table_valid_ ? BuildAxisAccelerator(x_axis_) : AxisAccelerator();
+    if (table_valid_)
+    {
+        // Keep the last results and the specified values when the channel count is unchanged
+        if (lookup_result_.size() != y_table_.rows())
+        {
+            lookup_result_ = Eigen::VectorXd::Zero(y_table_.rows());
+        }
+        if (lower_extrap_values_.size() != y_table_.rows() || upper_extrap_values_.size() != y_table_.rows())
+        {
+            lower_extrap_values_ = y_table_.col(0);
+            upper_extrap_values_ = y_table_.col(y_table_.cols() - 1);
+        }
+    }
+    return table_valid_;
+}
+
+LookupTable::TableState MultiLookupTable1D::CheckTableState(const Eigen::RowVectorXd &x_axis, const Eigen::MatrixXd &y_table)
+{
+    if (x_axis.size() == 0 || y_table.size() == 0)
+    {
+        return TableState::empty;
+    }
+    else if (x_axis.size() > max_table_size_ || x_axis.size() < 2)
+    {
+        return TableState::size_invalid;
+    }
+    else if (x_axis.size() != y_table.cols())
+    {
+        return TableState::size_not_match; // one column per breakpoint
+    }
+    else if (!isStrictlyIncreasing(x_axis))
+    {
+        return TableState::axis_not_increase;
+    }
+    else
+    {
+        return TableState::valid;
+    }
+}
+
+// Configurations of lookup methods
+void MultiLookupTable1D::SetExtrapMethod(const ExtrapMethod &method)
+{
+    extrap_method_ = method;
+    if (table_valid_)
+    {
+        lower_extrap_values_ = y_table_.col(0);
+        upper_extrap_values_ = y_table_.col(y_table_.cols() - 1);
+    }
+}
+void MultiLookupTable1D::SetExtrapMethod(const ExtrapMethod &method, const Eigen::VectorXd &lower_values, const Eigen::VectorXd &upper_values)
+{
+    extrap_method_ = method;
+    lower_extrap_values_ = lower_values;
+    upper_extrap_values_ = upper_values;
+}
+
+// Interpolation or extrapolation, the same formulas as LookupTable1D applied to whole breakpoint columns
+void MultiLookupTable1D::Evaluate(const std::size_t &index, const double &xvalue, Eigen::Ref<Eigen::VectorXd> results) const
+{
+    // Specified values of the wrong size act as clip
+    const bool specify = lower_extrap_values_.size() == results.size() && upper_extrap_values_.size() == results.size();
+    const Eigen::Ref<const Eigen::VectorXd> lower_values = specify ? Eigen::Ref<const Eigen::VectorXd>(lower_extrap_values_) : Eigen::Ref<const Eigen::VectorXd>(y_table_.col(0));
+    const Eigen::Ref<const Eigen::VectorXd> upper_values = specify ? Eigen::Ref<const Eigen::VectorXd>(upper_extrap_values_) : Eigen::Ref<const Eigen::VectorXd>(y_table_.col(table_size_ - 1));
+    EvaluateSegment(index, table_size_, xvalue, x_axis_.data(), [this](const std::size_t &i) { return y_table_.col(i); }, lower_values, upper_values, results);
+}
+
+// Final function LookupTable
+const Eigen::VectorXd &MultiLookupTable1D::Lookup(const double &xvalue)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        prelook_index_ = SearchAxis(xvalue, x_axis_, x_accelerator_, search_method_, prelook_index_, x_adaptive_);
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        Evaluate(prelook_index_, xvalue, lookup_result_);
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+    }
+    return lookup_result_;
+}
+
+// Thread-safe lookup, only the cursor and the results are written
+void MultiLookupTable1D::Lookup(const double &xvalue, Eigen::Ref<Eigen::VectorXd> results, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_ && results.size() == y_table_.rows())
+    {
+        cursor.row_index = SearchAxis(xvalue, x_axis_, x_accelerator_, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index, cursor.row_adaptive);
+        cursor.primed = true;
+        Evaluate(cursor.row_index, xvalue, results);
+        cursor.result = results(0);
+    }
+}
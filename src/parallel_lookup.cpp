@@ -0,0 +1,134 @@
+#include "parallel_lookup.h"
+
+constexpr std::size_t ParallelLookup::default_chunk_size_;
+
+ParallelLookup::ParallelLookup(const std::size_t &threads, const std::size_t &chunk_size) : chunk_size_{chunk_size > 0 ? chunk_size : default_chunk_size_}
+{
+    std::size_t count = threads > 0 ? threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+    ranges_.reset(new WorkRange[count]);
+    cursors_.resize(count);
+    for (std::size_t thread = 1; thread < count; ++thread)
+    {
+        workers_.emplace_back(&ParallelLookup::WorkerLoop, this, thread);
+    }
+}
+
+ParallelLookup::~ParallelLookup()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_condition_.notify_all();
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ParallelLookup::Lookup(const LookupTable1D &table, const double *xvalues, double *results, const std::size_t &count)
+{
+    Run(count, [&](const std::size_t &begin, const std::size_t &end, LookupTable::LookupCursor &cursor)
+        { table.Lookup(xvalues + begin, results + begin, end - begin, cursor); });
+}
+void ParallelLookup::Lookup(const LookupTable1D &table, const std::vector<double> &xvalues, std::vector<double> &results)
+{
+    results.resize(xvalues.size());
+    Lookup(table, xvalues.data(), results.data(), xvalues.size());
+}
+void ParallelLookup::Lookup(const LookupTable2D &table, const double *rvalues, const double *cvalues, double *results, const std::size_t &count)
+{
+    Run(count, [&](const std::size_t &begin, const std::size_t &end, LookupTable::LookupCursor &cursor)
+        { table.Lookup(rvalues + begin, cvalues + begin, results + begin, end - begin, cursor); });
+}
+void ParallelLookup::Lookup(const LookupTable2D &table, const std::vector<double> &rvalues, const std::vector<double> &cvalues, std::vector<double> &results)
+{
+    std::size_t count = std::min(rvalues.size(), cvalues.size());
+    results.resize(count);
+    Lookup(table, rvalues.data(), cvalues.data(), results.data(), count);
+}
+
+void ParallelLookup::Run(const std::size_t &count, const RangeTask &task)
+{
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    steals_.store(0);
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Split the chunks into one contiguous range per thread, neighbouring inputs stay on one thread for the search
+    const std::size_t chunks = (count + chunk_size_ - 1) / chunk_size_;
+    const std::size_t thread_count = threads();
+    for (std::size_t thread = 0; thread != thread_count; ++thread)
+    {
+        ranges_[thread].next.store(chunks * thread / thread_count);
+        ranges_[thread].end = chunks * (thread + 1) / thread_count;
+        cursors_[thread].Reset();
+    }
+    if (chunks == 1 || workers_.empty())
+    {
+        task_ = &task;
+        count_ = count;
+        Work(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        pending_ = workers_.size();
+        ++generation_;
+    }
+    start_condition_.notify_all();
+    Work(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_condition_.wait(lock, [this]
+                         { return pending_ == 0; });
+}
+
+void ParallelLookup::WorkerLoop(const std::size_t &thread)
+{
+    std::uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_condition_.wait(lock, [&]
+                                  { return stop_ || generation_ != seen; });
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+        }
+        Work(thread);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_;
+        }
+        done_condition_.notify_one();
+    }
+}
+
+// Own range first, then steal from the ranges of the following threads
+void ParallelLookup::Work(const std::size_t &thread)
+{
+    const std::size_t thread_count = threads();
+    LookupTable::LookupCursor &cursor = cursors_[thread];
+    for (std::size_t k = 0; k != thread_count; ++k)
+    {
+        WorkRange &range = ranges_[(thread + k) % thread_count];
+        for (std::size_t chunk = range.next.fetch_add(1); chunk < range.end; chunk = range.next.fetch_add(1))
+        {
+            const std::size_t begin = chunk * chunk_size_;
+            const std::size_t end = std::min(begin + chunk_size_, count_);
+            (*task_)(begin, end, cursor);
+            if (k != 0)
+            {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "prelookup.h"
+
+// Assign axis data with new input values, validate first.
+LookupTable::AssignmentState Prelookup::AssignTableData(const Eigen::RowVectorXd &axis)
+{
+    if (CheckTableState(axis) == TableState::valid)
+    {
+        axis_ = axis;
+        bool refresh = RefreshTableState(); // redundant check, and refresh state in table
+        return table_valid_ ? AssignmentState::success : AssignmentState::fail;
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+        return table_valid_ ? AssignmentState::remain : AssignmentState::fail;
+    }
+}
+LookupTable::AssignmentState Prelookup::AssignTableData(const std::vector<double> &axis_vec)
+{
+    Eigen::RowVectorXd axis = Eigen::Map<const Eigen::RowVectorXd>(axis_vec.data(), axis_vec.size());
+    return AssignTableData(axis);
+}
+
+bool Prelookup::ClearTable()
+{
+    axis_.resize(0);
+    bool refresh = RefreshTableState(); // resets the state to empty
+    return true;
+}
+
+bool Prelookup::RefreshTableState()
+{
+    table_state_ = CheckTableState(axis_);
+    table_size_ = ConvertSizeDataType(axis_.size());
+    table_valid_ = table_state_ == TableState::valid;
+    table_empty_ = table_state_ == TableState::empty;
+    accelerator_ = table_valid_ ? BuildAxisAccelerator(axis_) : AxisAccelerator();
+    return table_valid_;
+}
+
+LookupTable::TableState Prelookup::CheckTableState(const Eigen::RowVectorXd &input_vector)
+{
+    if (input_vector.size() == 0)
+    {
+        return TableState::empty;
+    }
+    else if (input_vector.size() > max_table_size_ || input_vector.size() < 2)
+    {
+        return TableState::size_invalid;
+    }
+    else if (!isStrictlyIncreasing(input_vector))
+    {
+        return TableState::axis_not_increase;
+    }
+    else
+    {
+        return TableState::valid;
+    }
+}
+
+// Same weight as LookupTable::Interpolate, so the tables reproduce their own Lookup results
+LookupTable::PrelookupResult Prelookup::Fraction(const std::size_t &index, const double &value) const
+{
+    const std::size_t segment = std::min(std::max(index, std::size_t(1)), table_size_ - 1);
+    const double &x1 = axis_(segment - 1);
+    const double &x2 = axis_(segment);
+    bool equal_zero = std::abs(x2 - x1) < epsilon_;
+    PrelookupResult result;
+    result.index = index;
+    result.fraction = equal_zero ? 0.5 : (value - x1) / (x2 - x1);
+    return result;
+}
+
+LookupTable::PrelookupResult Prelookup::Lookup(const double &value)
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        std::size_t index = SearchAxis(value, axis_, accelerator_, search_method_, lookup_result_.index);
+        search_method_ = NextSearchMethod(search_method_); // set to near after the first search, adaptive stays adaptive
+        lookup_result_ = Fraction(index, value);
+    }
+    else
+    {
+        bool refresh = RefreshTableState();
+    }
+    return lookup_result_;
+}
+LookupTable::PrelookupResult Prelookup::Lookup(const double &value, LookupCursor &cursor) const
+{
+    LookupTimer timer = StartLookupTimer();
+    if (table_valid_)
+    {
+        PrelookupResult result = Fraction(SearchAxis(value, axis_, accelerator_, cursor.primed ? NextSearchMethod(search_method_) : search_method_, cursor.row_index), value);
+        cursor.row_index = result.index;
+        cursor.primed = true;
+        cursor.result = result.fraction;
+    }
+    // The cursor keeps the last result like the table cursors, index in row_index and fraction in result
+    PrelookupResult result;
+    result.index = cursor.row_index;
+    result.fraction = cursor.result;
+    return result;
+}
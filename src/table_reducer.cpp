@@ -0,0 +1,192 @@
+#include "table_reducer.h"
+#include <limits>
+
+// Greedy selection with one slope window per curve: from the last kept breakpoint, every later breakpoint narrows the
+// window to the slopes whose line passes within its tolerance. A breakpoint can end the segment if its own slope lies
+// in every window, and the search stops when a window closes. The cost is linear in the number of values.
+std::vector<std::size_t> TableReducer::SelectBreakpoints(const Eigen::RowVectorXd &axis, const Eigen::MatrixXd &values, const Eigen::MatrixXd &tolerance) const
+{
+    const std::size_t size = static_cast<std::size_t>(axis.size());
+    const Eigen::Index curves = values.cols();
+    std::vector<std::size_t> kept;
+    if (size == 0)
+    {
+        return kept;
+    }
+    kept.push_back(0);
+    Eigen::RowVectorXd lower(curves), upper(curves);
+    std::size_t anchor = 0;
+    while (anchor + 1 < size)
+    {
+        lower.setConstant(-std::numeric_limits<double>::infinity());
+        upper.setConstant(std::numeric_limits<double>::infinity());
+        std::size_t end = anchor + 1;
+        for (std::size_t j = anchor + 1; j != size; ++j)
+        {
+            const double step = axis(j) - axis(anchor);
+            bool fits = true;
+            bool open = true;
+            for (Eigen::Index c = 0; c != curves; ++c)
+            {
+                const double rise = values(j, c) - values(anchor, c);
+                const double slope = rise / step;
+                fits = fits && slope >= lower(c) && slope <= upper(c);
+                lower(c) = std::max(lower(c), (rise - tolerance(j, c)) / step);
+                upper(c) = std::min(upper(c), (rise + tolerance(j, c)) / step);
+                open = open && lower(c) <= upper(c);
+            }
+            end = fits ? j : end;
+            if (!open)
+            {
+                break;
+            }
+        }
+        kept.push_back(end);
+        anchor = end;
+    }
+    return kept;
+}
+
+Eigen::MatrixXd TableReducer::Tolerance(const Eigen::MatrixXd &values) const
+{
+    return (max_rel_error_ * values.array().abs()).max(max_abs_error_).matrix();
+}
+
+Eigen::MatrixXd TableReducer::Resample(const Eigen::RowVectorXd &axis, const Eigen::MatrixXd &values, const std::vector<std::size_t> &kept) const
+{
+    Eigen::MatrixXd resampled = values;
+    for (std::size_t s = 0; s + 1 < kept.size(); ++s)
+    {
+        const std::size_t first = kept[s];
+        const std::size_t last = kept[s + 1];
+        for (std::size_t k = first + 1; k < last; ++k)
+        {
+            const double weight = (axis(k) - axis(first)) / (axis(last) - axis(first));
+            resampled.row(k) = values.row(first) + weight * (values.row(last) - values.row(first));
+        }
+    }
+    return resampled;
+}
+
+void TableReducer::AccumulateError(ReductionReport &report, const double &reference, const double &value) const
+{
+    const double error = std::abs(value - reference);
+    report.max_abs_error = std::max(report.max_abs_error, error);
+    report.max_rel_error = std::max(report.max_rel_error, error / std::max(std::abs(reference), std::numeric_limits<double>::epsilon()));
+    ++report.samples;
+}
+
+// One-dimensional reduction
+LookupTable1D TableReducer::Reduce(const LookupTable1D &table, ReductionReport &report) const
+{
+    report = ReductionReport();
+    LookupTable1D reduced = table;
+    if (!table.valid())
+    {
+        return reduced;
+    }
+    const Eigen::RowVectorXd &x_axis = table.x_axis();
+    const Eigen::RowVectorXd &y_table = table.y_table();
+    report.original_rows = table.size();
+    report.original_bytes = 2 * table.size() * sizeof(double);
+    if (table.interp_method() == LookupTable::InterpMethod::linear)
+    {
+        const Eigen::MatrixXd values = y_table.transpose();
+        std::vector<std::size_t> kept = SelectBreakpoints(x_axis, values, Tolerance(values));
+        Eigen::RowVectorXd x_reduced(kept.size()), y_reduced(kept.size());
+        for (std::size_t i = 0; i != kept.size(); ++i)
+        {
+            x_reduced(i) = x_axis(kept[i]);
+            y_reduced(i) = y_table(kept[i]);
+        }
+        reduced.AssignTableData(x_reduced, y_reduced);
+    }
+    report.reduced_rows = reduced.size();
+    report.reduced_bytes = 2 * reduced.size() * sizeof(double);
+
+    // Measure at every original breakpoint and segment midpoint
+    LookupTable::LookupCursor original_cursor, reduced_cursor;
+    for (Eigen::Index i = 0; i != x_axis.size(); ++i)
+    {
+        AccumulateError(report, table.Lookup(x_axis(i), original_cursor), reduced.Lookup(x_axis(i), reduced_cursor));
+        if (i + 1 != x_axis.size())
+        {
+            const double midpoint = 0.5 * (x_axis(i) + x_axis(i + 1));
+            AccumulateError(report, table.Lookup(midpoint, original_cursor), reduced.Lookup(midpoint, reduced_cursor));
+        }
+    }
+    return reduced;
+}
+
+// Two-dimensional reduction. The reduced map is I_r(I_c(f)), linear interpolation along the kept rows of the map
+// interpolated along the kept columns, so the error at a value is its row reduction error plus at most the column
+// reduction error of the kept rows around it. The rows get half of every tolerance, and the columns of a kept row
+// get the least tolerance left by the row reduction at the original rows next to it.
+LookupTable2D TableReducer::Reduce(const LookupTable2D &table, ReductionReport &report) const
+{
+    report = ReductionReport();
+    LookupTable2D reduced = table;
+    if (!table.valid())
+    {
+        return reduced;
+    }
+    const Eigen::RowVectorXd &row_axis = table.row_axis();
+    const Eigen::RowVectorXd &col_axis = table.col_axis();
+    const Eigen::MatrixXd &map_matrix = table.map_matrix();
+    report.original_rows = table.rows();
+    report.original_cols = table.cols();
+    report.original_bytes = (table.rows() + table.cols() + table.rows() * table.cols()) * sizeof(double);
+    if (table.row_interp_method() == LookupTable::InterpMethod::linear && table.col_interp_method() == LookupTable::InterpMethod::linear)
+    {
+        const Eigen::MatrixXd tolerance = Tolerance(map_matrix);
+        std::vector<std::size_t> rows = SelectBreakpoints(row_axis, map_matrix, 0.5 * tolerance);
+        const Eigen::MatrixXd left = tolerance - (map_matrix - Resample(row_axis, map_matrix, rows)).cwiseAbs();
+
+        Eigen::MatrixXd kept_rows(rows.size(), map_matrix.cols());
+        Eigen::MatrixXd kept_tolerance(rows.size(), map_matrix.cols());
+        for (std::size_t s = 0; s != rows.size(); ++s)
+        {
+            const std::size_t first = s > 0 ? rows[s - 1] : rows[s];
+            const std::size_t last = s + 1 < rows.size() ? rows[s + 1] : rows[s];
+            kept_rows.row(s) = map_matrix.row(rows[s]);
+            kept_tolerance.row(s) = left.middleRows(first, last - first + 1).colwise().minCoeff();
+        }
+        std::vector<std::size_t> cols = SelectBreakpoints(col_axis, kept_rows.transpose(), kept_tolerance.transpose());
+
+        Eigen::RowVectorXd row_reduced(rows.size()), col_reduced(cols.size());
+        Eigen::MatrixXd map_reduced(rows.size(), cols.size());
+        for (std::size_t i = 0; i != rows.size(); ++i)
+        {
+            row_reduced(i) = row_axis(rows[i]);
+            for (std::size_t j = 0; j != cols.size(); ++j)
+            {
+                map_reduced(i, j) = map_matrix(rows[i], cols[j]);
+            }
+        }
+        for (std::size_t j = 0; j != cols.size(); ++j)
+        {
+            col_reduced(j) = col_axis(cols[j]);
+        }
+        reduced.AssignTableData(row_reduced, col_reduced, map_reduced);
+    }
+    report.reduced_rows = reduced.rows();
+    report.reduced_cols = reduced.cols();
+    report.reduced_bytes = (reduced.rows() + reduced.cols() + reduced.rows() * reduced.cols()) * sizeof(double);
+
+    // Measure at every original grid point and cell center
+    LookupTable::LookupCursor original_cursor, reduced_cursor;
+    for (Eigen::Index i = 0; i != row_axis.size(); ++i)
+    {
+        for (Eigen::Index j = 0; j != col_axis.size(); ++j)
+        {
+            AccumulateError(report, table.Lookup(row_axis(i), col_axis(j), original_cursor), reduced.Lookup(row_axis(i), col_axis(j), reduced_cursor));
+            if (i + 1 != row_axis.size() && j + 1 != col_axis.size())
+            {
+                const double rmid = 0.5 * (row_axis(i) + row_axis(i + 1));
+                const double cmid = 0.5 * (col_axis(j) + col_axis(j + 1));
+                AccumulateError(report, table.Lookup(rmid, cmid, original_cursor), reduced.Lookup(rmid, cmid, reduced_cursor));
+            }
+        }
+    }
+    return reduced;
+}
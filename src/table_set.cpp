@@ -0,0 +1,135 @@
+#include "table_set.h"
+#include <algorithm>
+
+constexpr std::size_t TableSet::alignment_;
+
+TableSet::Handle1D TableSet::Add(const LookupTable1D &table)
+{
+    Handle1D handle;
+    if (!table.valid() || !isViewMethod(table.interp_method()))
+    {
+        return handle;
+    }
+    TableRecord record;
+    record.dimensions = 1;
+    record.index = static_cast<std::uint32_t>(tables_1d_.size());
+    record.rows = table.size();
+    record.data.reserve(2 * record.rows);
+    record.data.insert(record.data.end(), table.x_axis().data(), table.x_axis().data() + record.rows);
+    record.data.insert(record.data.end(), table.y_table().data(), table.y_table().data() + record.rows);
+    record.search_method = table.search_method();
+    record.interp_method = table.interp_method();
+    record.extrap_method = table.extrap_method();
+    record.lower_value = table.lower_extrap_value();
+    record.upper_value = table.upper_extrap_value();
+    if (Stage(std::move(record)))
+    {
+        handle.index = static_cast<std::uint32_t>(tables_1d_.size());
+        handle.generation = generation_;
+        tables_1d_.emplace_back();
+    }
+    return handle;
+}
+
+TableSet::Handle2D TableSet::Add(const LookupTable2D &table)
+{
+    Handle2D handle;
+    if (!table.valid() || !isViewMethod(table.row_interp_method()) || !isViewMethod(table.col_interp_method()))
+    {
+        return handle;
+    }
+    TableRecord record;
+    record.dimensions = 2;
+    record.index = static_cast<std::uint32_t>(tables_2d_.size());
+    record.rows = table.rows();
+    record.cols = table.cols();
+    record.data.reserve(record.rows + record.cols + record.rows * record.cols);
+    record.data.insert(record.data.end(), table.row_axis().data(), table.row_axis().data() + record.rows);
+    record.data.insert(record.data.end(), table.col_axis().data(), table.col_axis().data() + record.cols);
+    record.data.insert(record.data.end(), table.map_matrix().data(), table.map_matrix().data() + record.rows * record.cols);
+    record.search_method = table.search_method();
+    record.interp_method = table.row_interp_method();
+    record.col_interp_method = table.col_interp_method();
+    record.extrap_method = table.extrap_method();
+    if (Stage(std::move(record)))
+    {
+        handle.index = static_cast<std::uint32_t>(tables_2d_.size());
+        handle.generation = generation_;
+        tables_2d_.emplace_back();
+    }
+    return handle;
+}
+
+bool TableSet::isViewMethod(const LookupTable::InterpMethod &method)
+{
+    return method != LookupTable::InterpMethod::cubic && method != LookupTable::InterpMethod::pchip && method != LookupTable::InterpMethod::akima;
+}
+
+bool TableSet::Stage(TableRecord &&record)
+{
+    if (built_ || records_.size() >= std::numeric_limits<std::uint32_t>::max())
+    {
+        return false;
+    }
+    records_.push_back(std::move(record));
+    return true;
+}
+
+bool TableSet::Build()
+{
+    if (built_ || records_.empty())
+    {
+        return false;
+    }
+
+    // One allocation for every table, packed back to back in the order of addition
+    std::size_t total = 0;
+    for (const auto &record : records_)
+    {
+        total += record.data.size();
+    }
+    const std::size_t line = alignment_ / sizeof(double);
+    arena_.assign(total + line, 0.0);
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(arena_.data());
+    arena_offset_ = ((alignment_ - address % alignment_) % alignment_) / sizeof(double);
+
+    double *position = arena_.data() + arena_offset_;
+    for (const auto &record : records_)
+    {
+        std::copy(record.data.begin(), record.data.end(), position);
+        if (record.dimensions == 1)
+        {
+            LookupTable1DView &view = tables_1d_[record.index];
+            view.AttachTableData(position, position + record.rows, record.rows);
+            view.SetSearchMethod(record.search_method);
+            view.SetInterpMethod(record.interp_method);
+            view.SetExtrapMethod(record.extrap_method, record.lower_value, record.upper_value);
+        }
+        else
+        {
+            LookupTable2DView &view = tables_2d_[record.index];
+            view.AttachTableData(position, position + record.rows, position + record.rows + record.cols, record.rows, record.cols, LookupTable2DView::Layout::col_major);
+            view.SetSearchMethod(record.search_method);
+            view.SetInterpMethod(record.interp_method, record.col_interp_method);
+            view.SetExtrapMethod(record.extrap_method);
+        }
+        position += record.data.size();
+    }
+    records_.clear();
+    records_.shrink_to_fit();
+    built_ = true;
+    return true;
+}
+
+void TableSet::Clear()
+{
+    records_.clear();
+    records_.shrink_to_fit();
+    arena_.clear();
+    arena_.shrink_to_fit();
+    arena_offset_ = 0;
+    tables_1d_.clear();
+    tables_2d_.clear();
+    built_ = false;
+    ++generation_;
+}
@@ -6,6 +6,30 @@
 int main()
 {
 	TestTable2D();
+	TestTable1DBatch();
+	TestTable2DBatch();
+	TestTableSharedCursor();
+	TestTableUniformAxis();
+	TestFixedTable();
+	TestTableND();
+	TestPrelookup();
+	TestTableSpline();
+	TestCompactTable();
+	TestCalibrationFile();
+	TestTableRegistry();
+	TestAdaptiveSearch();
+	TestAxisIndex();
+	TestSegmentCoefficients();
+	TestTableReducer();
+	TestInverseLookup();
+	TestLookupGradient();
+	TestSortedLookup();
+	TestMultiTable();
+	TestParallelLookup();
+	TestTableOwnership();
+	TestTableSet();
+	TestGeneratedTables();
+	TestLookupStatistics();
 
 	return 0;
 }
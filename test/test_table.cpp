@@ -53,4 +53,1082 @@ void TestTable2D()
 		}
 		std::cout << std::endl;
 	}
-}
\ No newline at end of file
+}
+
+void TestTable1DBatch()
+{
+	std::vector<double> x_vec{0, 1, 2, 3, 4, 5, 6, 7};
+	std::vector<double> y_vec{0, 1, 4, 9, 9, 4, 1, 0};
+	std::vector<double> x_value;
+	for (int i = 0; i != 1000; ++i)
+	{
+		x_value.push_back(-1.0 + 9.0 * std::abs(std::sin(0.37 * i))); // jumps back and forth, covers both extrapolation sides
+	}
+	std::vector<LookupTable::InterpMethod> interp_methods{LookupTable::InterpMethod::linear, LookupTable::InterpMethod::nearest, LookupTable::InterpMethod::next, LookupTable::InterpMethod::previous, LookupTable::InterpMethod::cubic, LookupTable::InterpMethod::pchip, LookupTable::InterpMethod::akima};
+	std::vector<LookupTable::ExtrapMethod> extrap_methods{LookupTable::ExtrapMethod::clip, LookupTable::ExtrapMethod::linear, LookupTable::ExtrapMethod::specify};
+	for (auto &interp : interp_methods)
+	{
+		for (auto &extrap : extrap_methods)
+		{
+			LookupTable1D scalar_table(x_vec, y_vec);
+			LookupTable1D batch_table(x_vec, y_vec);
+			scalar_table.SetInterpMethod(interp);
+			batch_table.SetInterpMethod(interp);
+			scalar_table.SetExtrapMethod(extrap, -1.0, 2.0);
+			batch_table.SetExtrapMethod(extrap, -1.0, 2.0);
+			std::vector<double> results;
+			batch_table.Lookup(x_value, results);
+			std::size_t mismatch = 0;
+			for (std::size_t i = 0; i != x_value.size(); ++i)
+			{
+				mismatch += scalar_table.Lookup(x_value[i]) != results[i];
+			}
+			std::cout << "batch 1d, interp " << static_cast<int>(interp) << ", extrap " << static_cast<int>(extrap) << ", mismatch: " << mismatch << std::endl;
+		}
+	}
+}
+
+void TestTable2DBatch()
+{
+	std::vector<double> row_vec = {1.0, 2.0, 3.0, 4.0};
+	std::vector<double> col_vec = {10.0, 20.0, 30.0};
+	std::vector<double> map_vec = {
+		11.0, 12.0, 13.0, // Row 1
+		21.0, 22.0, 23.0, // Row 2
+		31.0, 32.0, 33.0, // Row 3
+		41.0, 42.0, 43.0  // Row 4
+	};
+	LookupTable2D scalar_table(row_vec, col_vec, map_vec);
+	LookupTable2D batch_table(row_vec, col_vec, map_vec);
+	std::vector<double> row_value;
+	std::vector<double> col_value;
+	for (int i = 0; i != 1000; ++i)
+	{
+		row_value.push_back(0.5 + 4.0 * std::abs(std::sin(0.37 * i)));
+		col_value.push_back(5.0 + 30.0 * std::abs(std::cos(0.11 * i)));
+	}
+	std::vector<double> results;
+	batch_table.Lookup(row_value, col_value, results);
+	std::size_t mismatch = 0;
+	for (std::size_t i = 0; i != row_value.size(); ++i)
+	{
+		mismatch += scalar_table.Lookup(row_value[i], col_value[i]) != results[i];
+	}
+	std::cout << "batch 2d, mismatch: " << mismatch << std::endl;
+}
+
+void TestTableSharedCursor()
+{
+	std::vector<double> row_vec = {1.0, 2.0, 3.0, 4.0};
+	std::vector<double> col_vec = {10.0, 20.0, 30.0};
+	std::vector<double> map_vec = {11.0, 12.0, 13.0, 21.0, 22.0, 23.0, 31.0, 32.0, 33.0, 41.0, 42.0, 43.0};
+	const LookupTable2D shared_table(row_vec, col_vec, map_vec); // one copy, read by every thread
+	LookupTable2D reference_table(row_vec, col_vec, map_vec);
+	std::vector<double> row_value;
+	std::vector<double> col_value;
+	std::vector<double> reference;
+	for (int i = 0; i != 1000; ++i)
+	{
+		row_value.push_back(0.5 + 4.0 * std::abs(std::sin(0.37 * i)));
+		col_value.push_back(5.0 + 30.0 * std::abs(std::cos(0.11 * i)));
+		reference.push_back(reference_table.Lookup(row_value.back(), col_value.back()));
+	}
+	const std::size_t thread_count = 4;
+	std::vector<std::size_t> mismatch(thread_count, 0);
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t != thread_count; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			LookupTable::LookupCursor cursor;
+			for (std::size_t i = 0; i != row_value.size(); ++i)
+			{
+				mismatch[t] += shared_table.Lookup(row_value[i], col_value[i], cursor) != reference[i];
+			}
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	std::cout << "shared table, threads: " << thread_count << ", mismatch: " << std::accumulate(mismatch.begin(), mismatch.end(), std::size_t(0)) << std::endl;
+}
+
+void TestTableUniformAxis()
+{
+	Eigen::RowVectorXd axis = Eigen::RowVectorXd::LinSpaced(1001, -3.0, 7.0);
+	LookupTable1D table_1d(axis, axis.array().square().matrix());
+	LookupTable::AxisAccelerator accelerator;
+	accelerator.uniform = true;
+	accelerator.origin = axis(0);
+	accelerator.inverse_step = 1.0 / ((axis(axis.size() - 1) - axis(0)) / (axis.size() - 1));
+	std::size_t mismatch = 0;
+	for (int i = 0; i != 20000; ++i)
+	{
+		double value = -4.0 + 12.0 * std::abs(std::sin(0.731 * i));
+		mismatch += table_1d.SearchUniform(value, axis, accelerator) != table_1d.SearchBinary(value, axis);
+		mismatch += table_1d.SearchUniform(axis(i % axis.size()), axis, accelerator) != table_1d.SearchBinary(axis(i % axis.size()), axis);
+	}
+	std::cout << "uniform axis, size: " << axis.size() << ", mismatch against binary search: " << mismatch << std::endl;
+}
+
+void TestFixedTable()
+{
+	constexpr FixedLookupTable1D<8> fixed_1d({0, 1, 2, 3, 4, 5, 6, 7}, {0, 1, 4, 9, 9, 4, 1, 0});
+	static_assert(fixed_1d.valid(), "fixed 1d table must be valid");
+	static_assert(fixed_1d.Lookup(2.5) == 6.5, "fixed 1d lookup must be evaluated at compile time");
+	constexpr FixedLookupTable2D<4, 3> fixed_2d({1.0, 2.0, 3.0, 4.0}, {10.0, 20.0, 30.0}, {11.0, 12.0, 13.0, 21.0, 22.0, 23.0, 31.0, 32.0, 33.0, 41.0, 42.0, 43.0});
+	static_assert(fixed_2d.valid(), "fixed 2d table must be valid");
+	constexpr FixedLookupTable1D<3> invalid_1d({0, 2, 1}, {0, 1, 2});
+	static_assert(invalid_1d.state() == LookupTable::TableState::axis_not_increase, "decreasing axis must be rejected");
+
+	FixedLookupTable1D<8, LookupTable::InterpMethod::nearest, LookupTable::ExtrapMethod::linear> nearest_1d(fixed_1d.x_axis(), fixed_1d.y_table());
+	LookupTable1D table_1d(std::vector<double>(fixed_1d.x_axis().begin(), fixed_1d.x_axis().end()), std::vector<double>(fixed_1d.y_table().begin(), fixed_1d.y_table().end()));
+	table_1d.SetInterpMethod(LookupTable::InterpMethod::nearest);
+	table_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	LookupTable2D table_2d(std::vector<double>{1.0, 2.0, 3.0, 4.0}, std::vector<double>{10.0, 20.0, 30.0}, std::vector<double>{11.0, 12.0, 13.0, 21.0, 22.0, 23.0, 31.0, 32.0, 33.0, 41.0, 42.0, 43.0});
+	std::size_t mismatch = 0;
+	for (int i = 0; i != 1000; ++i)
+	{
+		double xvalue = -1.0 + 9.0 * std::abs(std::sin(0.37 * i));
+		double rvalue = 0.5 + 4.0 * std::abs(std::sin(0.37 * i));
+		double cvalue = 5.0 + 30.0 * std::abs(std::cos(0.11 * i));
+		mismatch += std::abs(nearest_1d.Lookup(xvalue) - table_1d.Lookup(xvalue)) > 1e-12;
+		mismatch += std::abs(fixed_2d.Lookup(rvalue, cvalue) - table_2d.Lookup(rvalue, cvalue)) > 1e-12;
+	}
+	std::cout << "fixed tables, mismatch against dynamic tables: " << mismatch << std::endl;
+}
+
+void TestTableND()
+{
+	// A trilinear function is reproduced exactly inside the table
+	auto function = [](double x, double y, double z) { return 1.0 + 2.0 * x + 3.0 * y - z + 0.5 * x * y * z; };
+	std::vector<std::vector<double>> axes{{0, 1, 3, 4}, {-2, 0, 2}, {10, 20, 25, 40, 50}};
+	std::vector<double> data;
+	for (auto x : axes[0])
+		for (auto y : axes[1])
+			for (auto z : axes[2])
+				data.push_back(function(x, y, z));
+	LookupTableND table_3d(axes, data);
+	table_3d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	table_3d.SetInterpMethod(LookupTable::InterpMethod::nearest); // ignored, the table stays multilinear
+	std::vector<double> points;
+	for (int i = 0; i != 500; ++i)
+	{
+		points.push_back(-0.5 + 5.0 * std::abs(std::sin(0.37 * i)));
+		points.push_back(-2.5 + 5.0 * std::abs(std::cos(0.11 * i)));
+		points.push_back(5.0 + 50.0 * std::abs(std::sin(0.07 * i)));
+	}
+	std::vector<double> results;
+	table_3d.Lookup(points, results);
+	double max_error = 0;
+	for (std::size_t i = 0; i != results.size(); ++i)
+	{
+		max_error = std::max(max_error, std::abs(results[i] - function(points[3 * i], points[3 * i + 1], points[3 * i + 2])));
+	}
+	std::cout << "nd table, dimensions: " << table_3d.dimensions() << ", valid: " << table_3d.valid() << ", linear: " << (table_3d.interp_method() == LookupTable::InterpMethod::linear) << ", max error: " << max_error << std::endl;
+}
+
+void TestPrelookup()
+{
+	// Several tables share the speed axis, the search is done once per step
+	std::vector<double> speed_vec{500, 1000, 1500, 2500, 4000, 6000};
+	std::vector<double> load_vec{0.0, 0.5, 1.0};
+	Prelookup speed_prelookup(speed_vec);
+	Prelookup load_prelookup(load_vec);
+	LookupTable1D torque_1d(speed_vec, std::vector<double>{80, 120, 160, 190, 170, 130});
+	LookupTable1D friction_1d(speed_vec, std::vector<double>{5, 7, 9, 12, 18, 27});
+	friction_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	LookupTable2D fuel_2d(speed_vec, load_vec, std::vector<double>{1, 2, 3, 2, 4, 6, 3, 6, 9, 4, 8, 12, 5, 10, 15, 6, 12, 18});
+	LookupTable1D torque_reference(speed_vec, std::vector<double>{80, 120, 160, 190, 170, 130});
+	LookupTable1D friction_reference(speed_vec, std::vector<double>{5, 7, 9, 12, 18, 27});
+	friction_reference.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	LookupTable2D fuel_reference(speed_vec, load_vec, std::vector<double>{1, 2, 3, 2, 4, 6, 3, 6, 9, 4, 8, 12, 5, 10, 15, 6, 12, 18});
+	std::size_t mismatch = 0;
+	for (int i = 0; i != 1000; ++i)
+	{
+		double speed = 7000.0 * std::abs(std::sin(0.013 * i));
+		double load = -0.2 + 1.4 * std::abs(std::cos(0.05 * i));
+		LookupTable::PrelookupResult speed_index = speed_prelookup.Lookup(speed);
+		LookupTable::PrelookupResult load_index = load_prelookup.Lookup(load);
+		mismatch += torque_1d.Lookup(speed_index) != torque_reference.Lookup(speed);
+		mismatch += friction_1d.Lookup(speed_index) != friction_reference.Lookup(speed);
+		mismatch += std::abs(fuel_2d.Lookup(speed_index, load_index) - fuel_reference.Lookup(speed, load)) > 1e-12;
+	}
+
+	// The cursor form gives the same results, and keeps the last one once the axis is cleared
+	LookupTable::LookupCursor cursor;
+	LookupTable::PrelookupResult last = speed_prelookup.Lookup(1234.0, cursor);
+	mismatch += last.index != speed_prelookup.Lookup(1234.0).index || last.fraction != speed_prelookup.Lookup(1234.0).fraction;
+	speed_prelookup.ClearTable();
+	LookupTable::PrelookupResult kept = speed_prelookup.Lookup(5000.0, cursor);
+	mismatch += kept.index != last.index || kept.fraction != last.fraction;
+	std::cout << "prelookup, mismatch against direct lookup: " << mismatch << std::endl;
+}
+
+void TestTableSpline()
+{
+	// Coarse samples of a smooth curve, the spline methods need far fewer breakpoints than linear for the same error
+	const double pi = std::acos(-1.0);
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(9, 0.0, pi);
+	Eigen::RowVectorXd y_table = x_axis.array().sin();
+	Eigen::MatrixXd map_matrix = y_table.transpose() * x_axis.array().cos().matrix();
+	std::vector<LookupTable::InterpMethod> interp_methods{LookupTable::InterpMethod::linear, LookupTable::InterpMethod::cubic, LookupTable::InterpMethod::pchip, LookupTable::InterpMethod::akima};
+	for (auto &interp : interp_methods)
+	{
+		LookupTable1D table_1d(x_axis, y_table);
+		LookupTable2D table_2d(x_axis, x_axis, map_matrix);
+		table_1d.SetInterpMethod(interp);
+		table_2d.SetInterpMethod(interp);
+		double max_error_1d = 0;
+		double max_error_2d = 0;
+		for (int i = 0; i <= 200; ++i)
+		{
+			double xvalue = pi * i / 200;
+			double yvalue = pi * std::abs(std::sin(0.37 * i));
+			max_error_1d = std::max(max_error_1d, std::abs(table_1d.Lookup(xvalue) - std::sin(xvalue)));
+			max_error_2d = std::max(max_error_2d, std::abs(table_2d.Lookup(xvalue, yvalue) - std::sin(xvalue) * std::cos(yvalue)));
+		}
+		std::cout << "spline, interp " << static_cast<int>(interp) << ", max error 1d: " << max_error_1d << ", 2d: " << max_error_2d << std::endl;
+	}
+}
+
+
+void TestCompactTable()
+{
+	// Same curve stored as double, float, Q31 and Q15, the error of the compact tables is reported against the double table
+	const double pi = std::acos(-1.0);
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(64, 0.0, 2 * pi);
+	Eigen::RowVectorXd y_table = 100.0 * x_axis.array().sin();
+	Eigen::MatrixXd map_matrix = y_table.transpose() * x_axis.array().cos().matrix();
+	LookupTable1D reference_1d(x_axis, y_table);
+	LookupTable2D reference_2d(x_axis, x_axis, map_matrix);
+	LookupTable1DFloat float_1d(reference_1d);
+	LookupTable1DQ31 q31_1d(reference_1d);
+	LookupTable1DQ15 q15_1d(reference_1d);
+	LookupTable2DFloat float_2d(reference_2d);
+	LookupTable2DQ15 q15_2d(reference_2d);
+	std::vector<CompactLookupTable::QuantizationReport> reports{float_1d.AccuracyReport(reference_1d), q31_1d.AccuracyReport(reference_1d), q15_1d.AccuracyReport(reference_1d),
+																float_2d.AccuracyReport(reference_2d), q15_2d.AccuracyReport(reference_2d)};
+	std::vector<std::string> names{"float 1d", "q31 1d", "q15 1d", "float 2d", "q15 2d"};
+	for (std::size_t i = 0; i != reports.size(); ++i)
+	{
+		std::cout << "compact " << names[i] << ", max error: " << reports[i].max_abs_error << ", rms error: " << reports[i].rms_error
+				  << ", bytes: " << reports[i].compact_bytes << " / " << reports[i].reference_bytes << std::endl;
+	}
+
+	// The stateful and cursor lookups agree, and the error stays within half a quantization step
+	std::size_t mismatch = 0;
+	LookupTable::LookupCursor cursor;
+	for (int i = 0; i != 1000; ++i)
+	{
+		double xvalue = -1.0 + 8.5 * std::abs(std::sin(0.011 * i));
+		double q15_value = q15_1d.Lookup(xvalue);
+		mismatch += q15_value != q15_1d.Lookup(xvalue, cursor);
+		mismatch += std::abs(q15_value - reference_1d.Lookup(xvalue)) > 0.5 * q15_1d.scale() + 1e-12;
+	}
+
+	// A spline reference reports the same quantization error as its linear form
+	LookupTable1D spline_1d(reference_1d);
+	spline_1d.SetInterpMethod(LookupTable::InterpMethod::pchip);
+	LookupTable2D spline_2d(reference_2d);
+	spline_2d.SetInterpMethod(LookupTable::InterpMethod::linear, LookupTable::InterpMethod::cubic);
+	mismatch += LookupTable1DQ15(spline_1d).AccuracyReport(spline_1d).max_abs_error != reports[2].max_abs_error;
+	mismatch += LookupTable2DQ15(spline_2d).AccuracyReport(spline_2d).max_abs_error != reports[4].max_abs_error;
+	std::cout << "compact, mismatch: " << mismatch << std::endl;
+}
+
+void TestCalibrationFile()
+{
+	// Many named tables written once, then mapped and looked up through views without copying
+	const std::string path = "calibration_test.bin";
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(50, 0.0, 10.0);
+	Eigen::RowVectorXd y_table = x_axis.array().square();
+	Eigen::MatrixXd map_matrix = y_table.transpose() * x_axis.array().sqrt().matrix();
+	LookupTable1D table_1d(x_axis, y_table);
+	table_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	LookupTable2D table_2d(x_axis, x_axis, map_matrix);
+	CalibrationFileWriter writer;
+	bool added = true;
+	for (int i = 0; i != 100; ++i)
+	{
+		added = writer.AddTable("curve_" + std::to_string(i), table_1d) && writer.AddTable("map_" + std::to_string(i), table_2d) && added;
+	}
+	bool written = writer.Write(path);
+
+	CalibrationFile file(path);
+	LookupTable1DView view_1d = file.Table1D("curve_42");
+	LookupTable2DView view_2d = file.Table2D("map_7");
+	std::size_t mismatch = 0;
+	LookupTable::LookupCursor cursor;
+	for (int i = 0; i != 1000; ++i)
+	{
+		double xvalue = -1.0 + 12.0 * std::abs(std::sin(0.01 * i));
+		double yvalue = 11.0 * std::abs(std::cos(0.03 * i));
+		mismatch += view_1d.Lookup(xvalue) != table_1d.Lookup(xvalue);
+		mismatch += view_2d.Lookup(xvalue, yvalue, cursor) != table_2d.Lookup(xvalue, yvalue);
+	}
+
+	// Spline curves are not written, a view set to a spline is invalid
+	LookupTable1D spline_1d(table_1d);
+	spline_1d.SetInterpMethod(LookupTable::InterpMethod::akima);
+	LookupTable1DView spline_view = file.Table1D("curve_3");
+	spline_view.SetInterpMethod(LookupTable::InterpMethod::cubic);
+	mismatch += writer.AddTable("spline", spline_1d) || spline_view.valid();
+	std::cout << "calibration file, added: " << added << ", written: " << written << ", tables: " << file.size() << ", views valid: " << view_1d.valid() << view_2d.valid()
+			  << ", missing valid: " << file.Table1D("map_7").valid() << ", mismatch: " << mismatch << std::endl;
+	file.Close();
+
+	// A flipped byte in the data is caught by the checksum
+	std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+	stream.seekp(-8, std::ios::end);
+	stream.put('x');
+	stream.close();
+	CalibrationFile corrupted(path);
+	std::cout << "calibration file, corrupted state: " << static_cast<int>(corrupted.state()) << std::endl;
+	std::remove(path.c_str());
+}
+
+void TestTableRegistry()
+{
+	// One writer republishes y = k * x while readers keep looking it up, every result must come from one whole table
+	const int versions = 200;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(1000, 1.0, 1000.0);
+	TableRegistry1D registry;
+	std::size_t published = registry.Publish("gain", LookupTable1D(x_axis, x_axis)) == LookupTable::AssignmentState::success;
+	TableRegistry1D::SlotHandle slot = registry.Find("gain");
+	std::atomic<bool> done{false};
+	std::vector<std::size_t> mismatches(3, 0);
+	std::vector<std::thread> readers;
+	for (std::size_t t = 0; t != mismatches.size(); ++t)
+	{
+		readers.emplace_back([&, t]()
+							 {
+			std::size_t reader = registry.RegisterReader();
+			TableRegistry1D::SlotCursor cursor;
+			for (int i = 0; !done.load() || i < 10000; ++i)
+			{
+				double xvalue = 1.0 + (i * 37 + t * 101) % 1000;
+				double gain = registry.Lookup(slot, reader, cursor, xvalue) / xvalue;
+				mismatches[t] += std::abs(gain - std::round(gain)) > 1e-9 || gain < 1 || gain > versions;
+			}
+			registry.UnregisterReader(reader); });
+	}
+	for (int k = 2; k <= versions; ++k)
+	{
+		published += registry.Publish("gain", LookupTable1D(x_axis, k * x_axis)) == LookupTable::AssignmentState::success;
+	}
+	done.store(true);
+	for (auto &reader : readers)
+	{
+		reader.join();
+	}
+	std::cout << "registry, published: " << published << " / " << versions << ", mismatch: " << std::accumulate(mismatches.begin(), mismatches.end(), std::size_t(0))
+			  << ", rejected invalid: " << (registry.Publish("gain", LookupTable1D()) == LookupTable::AssignmentState::remain)
+			  << ", retired left: " << registry.Reclaim() << std::endl;
+}
+
+void TestAdaptiveSearch()
+{
+	// Smooth, jumping and alternating inputs on a graded axis, the adaptive method must give the binary search index
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(100000, 0.0, 99999.0);
+	x_axis = x_axis.array() + x_axis.array().square() / 100000.0;
+	Eigen::RowVectorXd y_table = x_axis.array().sqrt();
+	LookupTable1D adaptive_1d(x_axis, y_table);
+	LookupTable1D binary_1d(x_axis, y_table);
+	adaptive_1d.SetSearchMethod(LookupTable::SearchMethod::adaptive);
+	LookupTable::LookupCursor cursor;
+	std::size_t mismatch = 0;
+	for (int i = 0; i != 30000; ++i)
+	{
+		double smooth = 100000.0 + 90000.0 * std::sin(0.0005 * i);
+		double jump = 199999.0 * std::abs(std::sin(1.7 * i)) - 1.0;
+		double xvalue = (i / 10000 == 0) ? smooth : (i / 10000 == 1) ? jump : ((i % 2 == 0) ? smooth : jump);
+		binary_1d.SetSearchMethod(LookupTable::SearchMethod::bin);
+		double expected = binary_1d.Lookup(xvalue);
+		mismatch += adaptive_1d.Lookup(xvalue) != expected;
+		mismatch += adaptive_1d.Lookup(xvalue, cursor) != expected;
+	}
+	std::cout << "adaptive search, method kept: " << (adaptive_1d.search_method() == LookupTable::SearchMethod::adaptive) << ", mismatch: " << mismatch << std::endl;
+}
+
+void TestAxisIndex()
+{
+	// Large uneven axis, the Eytzinger index must return the flat binary search index, breakpoints and edges included
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(300001, 0.0, 300000.0);
+	x_axis = x_axis.array() + x_axis.array().square() / 300000.0;
+	Eigen::RowVectorXd y_table = x_axis.array().sqrt();
+	LookupTable1D indexed_1d(x_axis, y_table);
+	LookupTable1D flat_1d(x_axis, y_table);
+	flat_1d.SetAxisIndex(false);
+	std::size_t mismatch = 0;
+	for (int i = 0; i != 100000; ++i)
+	{
+		double xvalue = (i % 3 == 0) ? x_axis((i * 7919) % x_axis.size()) : 600001.0 * std::abs(std::sin(0.37 * i)) - 0.5;
+		indexed_1d.SetSearchMethod(LookupTable::SearchMethod::bin);
+		flat_1d.SetSearchMethod(LookupTable::SearchMethod::bin);
+		mismatch += indexed_1d.Lookup(xvalue) != flat_1d.Lookup(xvalue);
+	}
+	std::vector<double> specials{x_axis(0), x_axis(x_axis.size() - 1), -1e300, 1e300, std::numeric_limits<double>::quiet_NaN()};
+	for (auto &xvalue : specials)
+	{
+		indexed_1d.SetSearchMethod(LookupTable::SearchMethod::bin);
+		flat_1d.SetSearchMethod(LookupTable::SearchMethod::bin);
+		double indexed = indexed_1d.Lookup(xvalue);
+		double flat = flat_1d.Lookup(xvalue);
+		mismatch += !(indexed == flat || (indexed != indexed && flat != flat));
+	}
+	std::cout << "axis index, mismatch against flat binary search: " << mismatch << std::endl;
+}
+
+void TestSegmentCoefficients()
+{
+	// Precomputed segment and cell coefficients against the weight formula, within rounding, and batch against scalar
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(200, 0.0, 199.0);
+	x_axis = x_axis.array() + x_axis.array().square() / 50.0;
+	Eigen::RowVectorXd y_table = (0.05 * x_axis.array()).sin() * 100.0;
+	LookupTable1D coeff_1d(x_axis, y_table);
+	LookupTable1D plain_1d(x_axis, y_table);
+	coeff_1d.SetSegmentCoefficients(true);
+	coeff_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	plain_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	std::size_t mismatch = 0;
+	std::vector<double> xvalues;
+	for (int i = 0; i != 5000; ++i)
+	{
+		xvalues.push_back(1000.0 * std::abs(std::sin(0.71 * i)) - 100.0);
+	}
+	std::vector<double> results;
+	LookupTable1D batch_1d = coeff_1d;
+	batch_1d.Lookup(xvalues, results);
+	for (std::size_t i = 0; i != xvalues.size(); ++i)
+	{
+		double coeff = coeff_1d.Lookup(xvalues[i]);
+		mismatch += std::abs(coeff - plain_1d.Lookup(xvalues[i])) > 1e-9 * (1.0 + std::abs(coeff));
+		mismatch += coeff != results[i];
+	}
+
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(40, -5.0, 34.0).array().cube() / 100.0;
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(30, 0.0, 29.0).array().square();
+	Eigen::MatrixXd map_matrix = (row_axis.transpose() * col_axis).array().sin() * 10.0 + row_axis.transpose().replicate(1, 30).array();
+	LookupTable2D coeff_2d(row_axis, col_axis, map_matrix);
+	LookupTable2D plain_2d(row_axis, col_axis, map_matrix);
+	coeff_2d.SetSegmentCoefficients(true);
+	std::vector<double> rvalues, cvalues;
+	for (int i = 0; i != 5000; ++i)
+	{
+		rvalues.push_back(450.0 * std::abs(std::sin(0.37 * i)) - 10.0);
+		cvalues.push_back(900.0 * std::abs(std::cos(0.53 * i)) - 20.0);
+	}
+	LookupTable2D batch_2d = coeff_2d;
+	batch_2d.Lookup(rvalues, cvalues, results);
+	for (std::size_t i = 0; i != rvalues.size(); ++i)
+	{
+		double coeff = coeff_2d.Lookup(rvalues[i], cvalues[i]);
+		mismatch += std::abs(coeff - plain_2d.Lookup(rvalues[i], cvalues[i])) > 1e-9 * (1.0 + std::abs(coeff));
+		mismatch += coeff != results[i];
+	}
+
+	// Switching the coefficients off restores the weight formula exactly
+	coeff_2d.SetSegmentCoefficients(false);
+	mismatch += coeff_2d.Lookup(rvalues[7], cvalues[7]) != plain_2d.Lookup(rvalues[7], cvalues[7]);
+	std::cout << "segment coefficients, mismatch against weight formula: " << mismatch << std::endl;
+}
+
+void TestTableReducer()
+{
+	// Over-sampled curve and map, the reduced tables must stay within the tolerance at every original breakpoint
+	std::size_t mismatch = 0;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(5000, 0.0, 10.0);
+	Eigen::RowVectorXd y_table = x_axis.array().sin() * 50.0 + x_axis.array().square();
+	LookupTable1D table_1d(x_axis, y_table);
+	TableReducer reducer(1e-3);
+	TableReducer::ReductionReport report_1d;
+	LookupTable1D reduced_1d = reducer.Reduce(table_1d, report_1d);
+	mismatch += !reduced_1d.valid() || report_1d.reduced_rows >= report_1d.original_rows / 4;
+	mismatch += report_1d.max_abs_error > 1e-3 * (1 + 1e-9);
+	mismatch += reduced_1d.x_axis()(0) != x_axis(0) || reduced_1d.x_axis()(reduced_1d.size() - 1) != x_axis(x_axis.size() - 1);
+
+	TableReducer relative_reducer(0.0, 1e-4);
+	TableReducer::ReductionReport report_rel;
+	LookupTable1D relative_1d = relative_reducer.Reduce(table_1d, report_rel);
+	mismatch += report_rel.reduced_rows >= report_rel.original_rows || report_rel.max_rel_error > 1e-4 * (1 + 1e-9);
+
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(400, 0.0, 4.0);
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(300, -1.0, 2.0).array().cube();
+	Eigen::MatrixXd map_matrix(400, 300);
+	for (Eigen::Index i = 0; i != 400; ++i)
+	{
+		for (Eigen::Index j = 0; j != 300; ++j)
+		{
+			map_matrix(i, j) = std::exp(-row_axis(i)) * std::sin(2.0 * col_axis(j)) + 0.1 * row_axis(i) * row_axis(i);
+		}
+	}
+	LookupTable2D table_2d(row_axis, col_axis, map_matrix);
+	TableReducer::ReductionReport report_2d;
+	LookupTable2D reduced_2d = reducer.Reduce(table_2d, report_2d);
+	mismatch += !reduced_2d.valid() || report_2d.reduced_rows >= report_2d.original_rows || report_2d.reduced_cols >= report_2d.original_cols;
+	mismatch += report_2d.max_abs_error > 1e-3 * (1 + 1e-9) || report_2d.reduced_bytes >= report_2d.original_bytes;
+
+	// Other interpolation methods are not reduced
+	table_1d.SetInterpMethod(LookupTable::InterpMethod::nearest);
+	LookupTable1D nearest_1d = reducer.Reduce(table_1d, report_1d);
+	mismatch += nearest_1d.size() != table_1d.size() || report_1d.max_abs_error != 0;
+	std::cout << "table reducer, 1D " << report_rel.original_rows << " -> " << reduced_1d.size()
+			  << ", 2D " << report_2d.original_rows << "x" << report_2d.original_cols << " -> " << report_2d.reduced_rows << "x" << report_2d.reduced_cols
+			  << ", mismatch: " << mismatch << std::endl;
+}
+
+void TestInverseLookup()
+{
+	// Forward lookup of the inverse result must give back the requested value, for rising and falling curves
+	std::size_t mismatch = 0;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(60, 0.0, 100.0);
+	Eigen::RowVectorXd rising = x_axis.array().sqrt() * 10.0 + 0.01 * x_axis.array();
+	Eigen::RowVectorXd falling = -rising;
+	LookupTable1D rising_1d(x_axis, rising);
+	LookupTable1D falling_1d(x_axis, falling);
+	LookupTable::LookupCursor rising_cursor;
+	mismatch += rising_1d.monotonicity() != LookupTable::Monotonicity::increasing || falling_1d.monotonicity() != LookupTable::Monotonicity::decreasing;
+	for (int i = 0; i <= 1000; ++i)
+	{
+		double yvalue = rising(0) + (rising(59) - rising(0)) * i / 1000.0;
+		double xvalue = rising_1d.InverseLookup(yvalue);
+		mismatch += std::abs(rising_1d.Lookup(xvalue) - yvalue) > 1e-9;
+		mismatch += xvalue != rising_1d.InverseLookup(yvalue, rising_cursor);
+		xvalue = falling_1d.InverseLookup(-yvalue);
+		mismatch += std::abs(falling_1d.Lookup(xvalue) + yvalue) > 1e-9;
+	}
+	mismatch += rising_1d.InverseLookup(rising(0) - 5.0) != x_axis(0) || rising_1d.InverseLookup(rising(59) + 5.0) != x_axis(59);
+	mismatch += falling_1d.InverseLookup(-rising(0) + 5.0) != x_axis(0) || falling_1d.InverseLookup(-rising(59) - 5.0) != x_axis(59);
+	rising_1d.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	double beyond = rising_1d.InverseLookup(rising(59) + 5.0);
+	mismatch += beyond <= x_axis(59) || std::abs(rising_1d.Lookup(beyond) - rising(59) - 5.0) > 1e-9;
+
+	// A table that is not monotone keeps its last inverse result
+	Eigen::RowVectorXd bump = (x_axis.array() * 0.1).sin();
+	LookupTable1D bump_1d(x_axis, bump);
+	mismatch += bump_1d.monotonicity() != LookupTable::Monotonicity::none || bump_1d.InverseLookup(0.5) != 0.0;
+
+	// 2D: torque map over speed (rows) and pedal (columns), solve the pedal for a requested torque
+	Eigen::RowVectorXd speed = Eigen::RowVectorXd::LinSpaced(20, 500.0, 6000.0);
+	Eigen::RowVectorXd pedal = Eigen::RowVectorXd::LinSpaced(15, 0.0, 1.0);
+	Eigen::MatrixXd torque(20, 15);
+	for (Eigen::Index i = 0; i != 20; ++i)
+	{
+		for (Eigen::Index j = 0; j != 15; ++j)
+		{
+			torque(i, j) = 300.0 * std::sqrt(pedal(j)) * (1.2 - speed(i) / 10000.0) - 20.0;
+		}
+	}
+	LookupTable2D torque_2d(speed, pedal, torque);
+	mismatch += torque_2d.col_monotonicity() != LookupTable::Monotonicity::increasing;
+	LookupTable::LookupCursor torque_cursor;
+	for (int i = 0; i != 1000; ++i)
+	{
+		double rvalue = 500.0 + 5500.0 * std::abs(std::sin(0.31 * i));
+		double zvalue = -20.0 + 150.0 * std::abs(std::cos(0.17 * i));
+		double cvalue = torque_2d.InverseLookup(rvalue, zvalue);
+		mismatch += std::abs(torque_2d.Lookup(rvalue, cvalue) - zvalue) > 1e-9;
+		mismatch += cvalue != torque_2d.InverseLookup(rvalue, zvalue, torque_cursor);
+	}
+	mismatch += torque_2d.InverseLookup(1000.0, 1e6) != 1.0 || torque_2d.InverseLookup(1000.0, -1e6) != 0.0;
+	std::cout << "inverse lookup, mismatch: " << mismatch << std::endl;
+}
+
+void TestLookupGradient()
+{
+	// Analytic derivatives against central differences away from the breakpoints, values against Lookup
+	std::size_t mismatch = 0;
+	const double step = 1e-6;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(25, 0.0, 12.0).array().square() / 12.0;
+	Eigen::RowVectorXd y_table = x_axis.array().sin() * 4.0 + x_axis.array();
+	std::vector<LookupTable::InterpMethod> methods{LookupTable::InterpMethod::linear, LookupTable::InterpMethod::cubic, LookupTable::InterpMethod::pchip, LookupTable::InterpMethod::nearest};
+	for (auto &method : methods)
+	{
+		LookupTable1D table(x_axis, y_table);
+		LookupTable1D reference(x_axis, y_table);
+		table.SetInterpMethod(method);
+		reference.SetInterpMethod(method);
+		table.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+		reference.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+		LookupTable::LookupCursor cursor;
+		std::vector<double> xvalues, results(400), derivatives(400);
+		for (int i = 0; i != 400; ++i)
+		{
+			xvalues.push_back(-1.0 + 14.0 * (i + 0.37) / 400.0);
+		}
+		table.LookupGradient(xvalues.data(), results.data(), derivatives.data(), xvalues.size(), cursor);
+		for (std::size_t i = 0; i != xvalues.size(); ++i)
+		{
+			double derivative = 0;
+			double value = table.LookupGradient(xvalues[i], derivative);
+			double difference = (reference.Lookup(xvalues[i] + step) - reference.Lookup(xvalues[i] - step)) / (2 * step);
+			mismatch += value != reference.Lookup(xvalues[i]) || value != results[i] || derivative != derivatives[i];
+			mismatch += method != LookupTable::InterpMethod::nearest && std::abs(derivative - difference) > 1e-5 * (1 + std::abs(difference));
+			mismatch += method == LookupTable::InterpMethod::nearest && xvalues[i] > 0.0 && xvalues[i] < 12.0 && derivative != 0.0;
+		}
+	}
+
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(12, 0.0, 5.0);
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(9, -2.0, 2.0).array().cube();
+	Eigen::MatrixXd map_matrix(12, 9);
+	for (Eigen::Index i = 0; i != 12; ++i)
+	{
+		for (Eigen::Index j = 0; j != 9; ++j)
+		{
+			map_matrix(i, j) = std::cos(row_axis(i)) * col_axis(j) + row_axis(i) * row_axis(i);
+		}
+	}
+	for (auto &method : methods)
+	{
+		LookupTable2D table(row_axis, col_axis, map_matrix);
+		LookupTable2D reference(row_axis, col_axis, map_matrix);
+		table.SetInterpMethod(method, LookupTable::InterpMethod::akima);
+		reference.SetInterpMethod(method, LookupTable::InterpMethod::akima);
+		LookupTable::LookupCursor cursor;
+		for (int i = 0; i != 400; ++i)
+		{
+			double rvalue = -0.5 + 6.0 * std::abs(std::sin(0.71 * i + 0.1));
+			double cvalue = -9.0 + 18.0 * std::abs(std::cos(0.43 * i + 0.2));
+			double row_derivative = 0, col_derivative = 0, row_cursor = 0, col_cursor = 0;
+			double value = table.LookupGradient(rvalue, cvalue, row_derivative, col_derivative);
+			double value_cursor = table.LookupGradient(rvalue, cvalue, row_cursor, col_cursor, cursor);
+			double row_difference = (reference.Lookup(rvalue + step, cvalue) - reference.Lookup(rvalue - step, cvalue)) / (2 * step);
+			double col_difference = (reference.Lookup(rvalue, cvalue + step) - reference.Lookup(rvalue, cvalue - step)) / (2 * step);
+			mismatch += value != reference.Lookup(rvalue, cvalue) || value != value_cursor || row_derivative != row_cursor || col_derivative != col_cursor;
+			mismatch += std::abs(row_derivative - row_difference) > 1e-5 * (1 + std::abs(row_difference));
+			mismatch += std::abs(col_derivative - col_difference) > 1e-5 * (1 + std::abs(col_difference));
+		}
+	}
+	std::cout << "lookup gradient, mismatch against finite differences: " << mismatch << std::endl;
+}
+
+void TestSortedLookup()
+{
+	// Merge lookups of sorted and unsorted inputs against the cursor lookup, then a streamed signal block by block
+	std::size_t mismatch = 0;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(500, 0.0, 499.0);
+	x_axis = x_axis.array() + x_axis.array().square() / 100.0;
+	Eigen::RowVectorXd y_table = x_axis.array().sqrt();
+	LookupTable1D table(x_axis, y_table);
+	std::vector<double> sweep, shuffled, results, expected;
+	for (int i = 0; i != 7000; ++i)
+	{
+		sweep.push_back(-50.0 + 3100.0 * i / 6999.0);
+		shuffled.push_back(3000.0 * std::abs(std::sin(0.61 * i)) - 20.0);
+	}
+	sweep.push_back(x_axis(0));
+	sweep.push_back(std::numeric_limits<double>::quiet_NaN());
+	for (auto *inputs : {&sweep, &shuffled})
+	{
+		LookupTable::LookupCursor sorted_cursor, cursor;
+		table.LookupSorted(*inputs, results, sorted_cursor);
+		for (std::size_t i = 0; i != inputs->size(); ++i)
+		{
+			double value = table.Lookup((*inputs)[i], cursor);
+			mismatch += !(results[i] == value || (results[i] != results[i] && value != value));
+		}
+	}
+
+	// Stream a ramp that is generated block by block and never held in memory as a whole
+	LookupStream1D stream(table, 256);
+	std::size_t next = 0;
+	const std::size_t length = 100000;
+	std::size_t checked = 0;
+	LookupTable::LookupCursor stream_cursor;
+	std::size_t total = stream.Run([&](double *buffer, const std::size_t &capacity)
+								   {
+		std::size_t count = 0;
+		for (; count != capacity && next != length; ++count, ++next)
+		{
+			buffer[count] = 2500.0 * next / length;
+		}
+		return count; },
+								   [&](const double *block, const std::size_t &count)
+								   {
+		for (std::size_t i = 0; i != count; ++i, ++checked)
+		{
+			mismatch += block[i] != table.Lookup(2500.0 * checked / length, stream_cursor);
+		}
+	});
+	mismatch += total != length || checked != length || stream.processed() != length;
+
+	// 2D sweep along both axes
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(40, 0.0, 39.0).array().square();
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(30, -3.0, 3.0);
+	Eigen::MatrixXd map_matrix = row_axis.transpose() * col_axis;
+	LookupTable2D table_2d(row_axis, col_axis, map_matrix);
+	std::vector<double> rvalues, cvalues;
+	for (int i = 0; i != 3000; ++i)
+	{
+		rvalues.push_back(-10.0 + 1600.0 * i / 2999.0);
+		cvalues.push_back(-4.0 + 8.0 * i / 2999.0 + 0.3 * std::sin(0.05 * i));
+	}
+	LookupStream2D stream_2d(table_2d);
+	results.resize(rvalues.size());
+	stream_2d.Process(rvalues.data(), cvalues.data(), results.data(), 1000);
+	stream_2d.Process(rvalues.data() + 1000, cvalues.data() + 1000, results.data() + 1000, 2000);
+	LookupTable::LookupCursor cursor_2d;
+	for (std::size_t i = 0; i != rvalues.size(); ++i)
+	{
+		mismatch += results[i] != table_2d.Lookup(rvalues[i], cvalues[i], cursor_2d);
+	}
+	std::cout << "sorted lookup, mismatch: " << mismatch << std::endl;
+}
+
+void TestMultiTable()
+{
+	// Every channel of a multi-output table must match a LookupTable1D of the same row
+	std::size_t mismatch = 0;
+	const std::size_t channels = 24;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(30, 500.0, 7000.0);
+	x_axis = x_axis.array() + 0.0001 * x_axis.array().square();
+	Eigen::MatrixXd y_table(channels, x_axis.size());
+	for (std::size_t c = 0; c != channels; ++c)
+	{
+		y_table.row(c) = (x_axis.array() * (0.0005 + 0.0001 * c)).sin() * (1.0 + c);
+	}
+	MultiLookupTable1D multi(x_axis, y_table);
+	mismatch += !multi.valid() || multi.channels() != channels || multi.size() != 30;
+	std::vector<LookupTable::InterpMethod> interp_methods{LookupTable::InterpMethod::linear, LookupTable::InterpMethod::nearest, LookupTable::InterpMethod::next, LookupTable::InterpMethod::previous};
+	std::vector<LookupTable::ExtrapMethod> extrap_methods{LookupTable::ExtrapMethod::clip, LookupTable::ExtrapMethod::linear, LookupTable::ExtrapMethod::specify};
+	Eigen::VectorXd results(channels);
+	for (auto &interp : interp_methods)
+	{
+		for (auto &extrap : extrap_methods)
+		{
+			multi.SetInterpMethod(interp);
+			multi.SetExtrapMethod(extrap);
+			std::vector<LookupTable1D> singles;
+			for (std::size_t c = 0; c != channels; ++c)
+			{
+				singles.emplace_back(x_axis, y_table.row(c));
+				singles.back().SetInterpMethod(interp);
+				singles.back().SetExtrapMethod(extrap);
+			}
+			LookupTable::LookupCursor cursor;
+			for (int i = 0; i != 300; ++i)
+			{
+				double xvalue = 9000.0 * std::abs(std::sin(0.29 * i)) - 500.0;
+				const Eigen::VectorXd &stateful = multi.Lookup(xvalue);
+				multi.Lookup(xvalue, results, cursor);
+				for (std::size_t c = 0; c != channels; ++c)
+				{
+					double single = singles[c].Lookup(xvalue);
+					mismatch += stateful(c) != single || results(c) != single;
+				}
+			}
+		}
+	}
+
+	// Invalid data keeps the previous table
+	Eigen::MatrixXd wrong_size = Eigen::MatrixXd::Zero(channels, 29);
+	mismatch += multi.AssignTableData(x_axis, wrong_size) != LookupTable::AssignmentState::remain || multi.size() != 30;
+	std::cout << "multi-output table, channels: " << channels << ", mismatch: " << mismatch << std::endl;
+}
+
+void TestParallelLookup()
+{
+	// Results must not depend on the thread count or the chunk size, and every input is evaluated exactly once
+	std::size_t mismatch = 0;
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(200, 0.0, 199.0).array().square();
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(150, -10.0, 10.0);
+	Eigen::MatrixXd map_matrix = (row_axis.transpose() * col_axis).array().sin();
+	LookupTable2D table(row_axis, col_axis, map_matrix);
+	table.SetSearchMethod(LookupTable::SearchMethod::adaptive);
+	const std::size_t count = 200003;
+	std::vector<double> rvalues(count), cvalues(count), expected(count), results;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		rvalues[i] = 41000.0 * std::abs(std::sin(0.013 * i)) - 100.0;
+		cvalues[i] = 22.0 * std::abs(std::cos(0.0007 * i * i)) - 11.0;
+	}
+	LookupTable::LookupCursor cursor;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		expected[i] = table.Lookup(rvalues[i], cvalues[i], cursor);
+	}
+	for (std::size_t threads : {1, 2, 3, 8})
+	{
+		for (std::size_t chunk : {1000, 4096})
+		{
+			ParallelLookup pool(threads, chunk);
+			pool.Lookup(table, rvalues, cvalues, results);
+			mismatch += pool.threads() != threads || results != expected;
+
+			std::vector<std::atomic<int>> visits(count);
+			pool.Run(count, [&](const std::size_t &begin, const std::size_t &end, LookupTable::LookupCursor &)
+					 {
+				for (std::size_t i = begin; i != end; ++i)
+				{
+					visits[i].fetch_add(1);
+				} });
+			mismatch += std::count_if(visits.begin(), visits.end(), [](const std::atomic<int> &visit)
+									  { return visit.load() != 1; });
+		}
+	}
+
+	ParallelLookup pool_1d(4);
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(5000, 0.0, 1.0).array().sqrt();
+	LookupTable1D table_1d(x_axis, x_axis.array().exp().matrix());
+	std::vector<double> xvalues(rvalues.begin(), rvalues.end());
+	for (auto &xvalue : xvalues)
+	{
+		xvalue /= 40000.0;
+	}
+	std::vector<double> results_1d;
+	pool_1d.Lookup(table_1d, xvalues, results_1d);
+	LookupTable::LookupCursor cursor_1d;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		mismatch += results_1d[i] != table_1d.Lookup(xvalues[i], cursor_1d);
+	}
+
+	// Default search method with inputs on the breakpoints of a graded axis, a chunk may start at any of them
+	Eigen::RowVectorXd graded_axis = Eigen::RowVectorXd::LinSpaced(11, 0.0, 10.0);
+	graded_axis(3) = 3.3;
+	LookupTable1D graded_1d(graded_axis, graded_axis.array().sin().matrix());
+	std::vector<double> breakpoints;
+	for (std::size_t i = 0; i != 4000; ++i)
+	{
+		breakpoints.push_back(graded_axis((i * 7 + i / 5) % 11));
+	}
+	breakpoints.insert(breakpoints.begin(), {7.0, 7.0, 5.0, 5.0});
+	for (auto method : {LookupTable::InterpMethod::next, LookupTable::InterpMethod::previous})
+	{
+		graded_1d.SetInterpMethod(method);
+		std::vector<double> single, multiple;
+		ParallelLookup pool_single(1, 2);
+		pool_single.Lookup(graded_1d, breakpoints, single);
+		for (std::size_t threads : {2, 3, 8})
+		{
+			ParallelLookup pool_multiple(threads, 2);
+			pool_multiple.Lookup(graded_1d, breakpoints, multiple);
+			mismatch += multiple != single;
+		}
+		for (std::size_t i = 0; i != breakpoints.size(); ++i)
+		{
+			mismatch += single[i] != graded_1d.Lookup(breakpoints[i]);
+		}
+	}
+	std::cout << "parallel lookup, mismatch: " << mismatch << std::endl;
+}
+
+void TestTableOwnership()
+{
+	// Moved-in data is adopted without a copy, and views over either layout match the owning table
+	std::size_t mismatch = 0;
+	const std::size_t rows = 17, cols = 23;
+	Eigen::RowVectorXd row_axis = Eigen::RowVectorXd::LinSpaced(rows, 0.0, 8.0);
+	Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(cols, -2.0, 9.0).array().cube();
+	Eigen::MatrixXd map_matrix(rows, cols);
+	std::vector<double> row_major(rows * cols);
+	for (std::size_t r = 0; r != rows; ++r)
+	{
+		for (std::size_t c = 0; c != cols; ++c)
+		{
+			map_matrix(r, c) = std::sin(0.3 * r) * std::cos(0.2 * c) + 0.01 * r * c;
+			row_major[r * cols + c] = map_matrix(r, c);
+		}
+	}
+	LookupTable2D copied(row_axis, col_axis, map_matrix);
+	LookupTable2D from_vector(std::vector<double>(row_axis.data(), row_axis.data() + rows), std::vector<double>(col_axis.data(), col_axis.data() + cols), row_major);
+	Eigen::RowVectorXd row_moved = row_axis, col_moved = col_axis;
+	Eigen::MatrixXd map_moved = map_matrix;
+	const double *map_buffer = map_moved.data();
+	LookupTable2D moved(std::move(row_moved), std::move(col_moved), std::move(map_moved));
+	mismatch += !moved.valid() || moved.map_matrix().data() != map_buffer || from_vector.map_matrix() != map_matrix;
+
+	LookupTable2DView row_view(row_axis.data(), col_axis.data(), row_major.data(), rows, cols);
+	LookupTable2DView col_view(row_axis.data(), col_axis.data(), map_matrix.data(), rows, cols, LookupTable2DView::Layout::col_major);
+	LookupTable2DView table_view(copied);
+	mismatch += row_view.map_matrix() != map_matrix || col_view.map_matrix() != map_matrix || table_view.map_matrix().data() != copied.map_matrix().data();
+	for (int i = 0; i != 500; ++i)
+	{
+		double rvalue = 10.0 * std::abs(std::sin(0.37 * i)) - 1.0;
+		double cvalue = 900.0 * std::sin(0.11 * i);
+		double expected = copied.Lookup(rvalue, cvalue);
+		mismatch += moved.Lookup(rvalue, cvalue) != expected || from_vector.Lookup(rvalue, cvalue) != expected;
+		mismatch += row_view.Lookup(rvalue, cvalue) != expected || col_view.Lookup(rvalue, cvalue) != expected || table_view.Lookup(rvalue, cvalue) != expected;
+	}
+
+	// A view takes the methods of its table and is invalid for the spline methods it cannot evaluate
+	copied.SetInterpMethod(LookupTable::InterpMethod::linear, LookupTable::InterpMethod::pchip);
+	LookupTable2DView spline_view(copied);
+	mismatch += spline_view.valid() || spline_view.col_interp_method() != LookupTable::InterpMethod::pchip;
+	spline_view.SetInterpMethod(LookupTable::InterpMethod::nearest);
+	mismatch += !spline_view.valid() || spline_view.Lookup(3.3, 100.0) != table_view.Lookup(3.3, 100.0);
+	row_view.SetInterpMethod(LookupTable::InterpMethod::cubic);
+	mismatch += row_view.valid();
+	CalibrationFileWriter spline_writer;
+	mismatch += spline_writer.AddTable("spline", copied) || !spline_writer.AddTable("linear", moved);
+
+	// 1D move keeps the buffers, invalid moved-in data stays with the caller
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(40, 0.0, 39.0);
+	Eigen::RowVectorXd y_table = x_axis.array().sqrt();
+	const double *y_buffer = y_table.data();
+	LookupTable1D curve(std::move(x_axis), std::move(y_table));
+	mismatch += !curve.valid() || curve.y_table().data() != y_buffer || curve.Lookup(16.0) != 4.0;
+	Eigen::RowVectorXd bad_axis = Eigen::RowVectorXd::Zero(40), bad_table = Eigen::RowVectorXd::Ones(40);
+	mismatch += curve.AssignTableData(std::move(bad_axis), std::move(bad_table)) != LookupTable::AssignmentState::remain || bad_axis.size() != 40 || curve.Lookup(16.0) != 4.0;
+
+	// A cleared table is invalid and keeps its last result
+	mismatch += !moved.ClearTable() || moved.valid() || moved.Lookup(1.0, 1.0) != moved.Lookup(2.0, 2.0);
+	std::cout << "table ownership and views, layouts: 2, mismatch: " << mismatch << std::endl;
+}
+
+void TestTableSet()
+{
+	// Tables packed into one arena must give the same results as the tables they were copied from
+	std::size_t mismatch = 0;
+	TableSet set;
+	std::vector<LookupTable1D> curves;
+	std::vector<LookupTable2D> maps;
+	std::vector<TableSet::Handle1D> handles_1d;
+	std::vector<TableSet::Handle2D> handles_2d;
+	for (std::size_t t = 0; t != 2000; ++t)
+	{
+		std::size_t size = 4 + t % 13;
+		Eigen::RowVectorXd axis = Eigen::RowVectorXd::LinSpaced(size, 0.0, 10.0).array() + 0.05 * Eigen::RowVectorXd::LinSpaced(size, 0.0, 10.0).array().square();
+		if (t % 4 != 3)
+		{
+			curves.emplace_back(axis, Eigen::RowVectorXd((axis.array() * (0.1 + 0.001 * t)).sin()));
+			curves.back().SetInterpMethod(t % 3 == 0 ? LookupTable::InterpMethod::nearest : LookupTable::InterpMethod::linear);
+			curves.back().SetExtrapMethod(t % 2 == 0 ? LookupTable::ExtrapMethod::linear : LookupTable::ExtrapMethod::clip);
+			handles_1d.push_back(set.Add(curves.back()));
+		}
+		else
+		{
+			Eigen::RowVectorXd col_axis = Eigen::RowVectorXd::LinSpaced(size + 2, -5.0, 5.0);
+			Eigen::MatrixXd map_matrix = Eigen::MatrixXd::Random(size, size + 2);
+			maps.emplace_back(axis, col_axis, map_matrix);
+			handles_2d.push_back(set.Add(maps.back()));
+		}
+	}
+	mismatch += set.Add(LookupTable1D()).valid();
+	LookupTable1D spline_curve(curves[0]);
+	LookupTable2D spline_map(maps[0]);
+	spline_curve.SetInterpMethod(LookupTable::InterpMethod::cubic);
+	spline_map.SetInterpMethod(LookupTable::InterpMethod::linear, LookupTable::InterpMethod::akima);
+	mismatch += set.Add(spline_curve).valid() || set.Add(spline_map).valid();
+	mismatch += !set.Build() || set.Build() || !set.built() || set.size() != 2000 || set.size_1d() != curves.size() || set.size_2d() != maps.size();
+	mismatch += reinterpret_cast<std::uintptr_t>(set.data()) % TableSet::alignment_ != 0 || set.Add(curves[0]).valid();
+
+	// Consecutive tables follow each other in the arena
+	mismatch += set.Table(handles_1d[0]).x_axis().data() != set.data() || set.Table(handles_1d[1]).x_axis().data() != set.data() + 2 * curves[0].size();
+	LookupTable::LookupCursor cursor;
+	for (int i = 0; i != 50; ++i)
+	{
+		double xvalue = 16.0 * std::abs(std::sin(0.41 * i)) - 2.0;
+		double cvalue = 7.0 * std::sin(0.23 * i);
+		for (std::size_t t = 0; t != curves.size(); ++t)
+		{
+			double expected = curves[t].Lookup(xvalue);
+			mismatch += set.Lookup(handles_1d[t], xvalue) != expected;
+			cursor.Reset();
+			mismatch += set.Lookup(handles_1d[t], xvalue, cursor) != expected;
+		}
+		for (std::size_t t = 0; t != maps.size(); ++t)
+		{
+			mismatch += set.Lookup(handles_2d[t], xvalue, cvalue) != maps[t].Lookup(xvalue, cvalue);
+		}
+	}
+	// Invalid handles reach an empty view
+	TableSet::Handle1D no_curve;
+	TableSet::Handle2D no_map;
+	mismatch += set.Table(no_curve).valid() || set.Lookup(no_curve, 1.0) != 0 || set.Table(no_map).valid() || set.Lookup(no_map, 1.0, 1.0) != 0;
+	std::size_t bytes = set.bytes();
+	set.Clear();
+	mismatch += set.built() || set.size() != 0 || set.bytes() != 0 || set.Table(handles_1d[0]).valid() || set.Lookup(handles_2d[0], 1.0, 1.0) != 0;
+
+	// A handle from before Clear does not reach the table that now has its index
+	TableSet::Handle1D renewed = set.Add(curves[0]);
+	mismatch += !set.Build() || renewed.index != handles_1d[0].index || !set.Table(renewed).valid() || set.Table(handles_1d[0]).valid();
+	std::cout << "table set, tables: 2000, arena bytes: " << bytes << ", mismatch: " << mismatch << std::endl;
+}
+
+void TestGeneratedTables()
+{
+	// Tables generated from test/data at build time are constexpr and match the runtime tables of the same data
+	static_assert(calibration::idle_speed.Lookup(-30.0) == 1250.0 && calibration::idle_speed.Lookup(-50.0) == 1350.0, "generated 1D table");
+	static_assert(calibration::boost_map.Lookup(3000.0, 50.0) == 155.0, "generated 2D table");
+	std::size_t mismatch = 0;
+	const auto &idle = calibration::idle_speed;
+	const auto &boost = calibration::boost_map;
+	LookupTable1D idle_runtime(std::vector<double>(idle.x_axis().begin(), idle.x_axis().end()), std::vector<double>(idle.y_table().begin(), idle.y_table().end()));
+	idle_runtime.SetExtrapMethod(LookupTable::ExtrapMethod::specify, 1350.0, 700.0);
+	std::vector<double> boost_data;
+	for (std::size_t r = 0; r != boost.rows(); ++r)
+	{
+		for (std::size_t c = 0; c != boost.cols(); ++c)
+		{
+			boost_data.push_back(boost.map(r, c));
+		}
+	}
+	LookupTable2D boost_runtime(std::vector<double>(boost.row_axis().begin(), boost.row_axis().end()), std::vector<double>(boost.col_axis().begin(), boost.col_axis().end()), boost_data);
+	mismatch += !idle_runtime.valid() || !boost_runtime.valid() || boost.map(1, 2) != 135.0;
+	for (int i = 0; i != 400; ++i)
+	{
+		double temperature = 180.0 * std::sin(0.13 * i);
+		double speed = 2500.0 + 2000.0 * std::sin(0.07 * i);
+		double pedal = 50.0 + 60.0 * std::cos(0.19 * i);
+		mismatch += idle.Lookup(temperature) != idle_runtime.Lookup(temperature);
+		mismatch += boost.Lookup(speed, pedal) != boost_runtime.Lookup(speed, pedal);
+	}
+	std::cout << "generated constexpr tables, tables: 2, mismatch: " << mismatch << std::endl;
+}
+
+void TestLookupStatistics()
+{
+	// Counters follow a known input sequence when LOOKUP_TABLE_STATISTICS is on, and stay empty when it is off
+	std::size_t mismatch = 0;
+	Eigen::RowVectorXd x_axis = Eigen::RowVectorXd::LinSpaced(101, 0.0, 100.0).array().square();
+	LookupTable1D table(x_axis, Eigen::RowVectorXd(x_axis.array().sqrt()));
+	table.SetSearchMethod(LookupTable::SearchMethod::near);
+	table.SetExtrapMethod(LookupTable::ExtrapMethod::linear);
+	for (int i = 0; i != 1100; ++i)
+	{
+		table.Lookup(10.0 * i); // a slow ramp, 0 is at the first breakpoint and 10000 to 10990 are above the axis
+	}
+	std::vector<double> inputs{-1.0, 50.0, 2500.0}, results;
+	table.Lookup(inputs, results);
+	LookupStatisticsSnapshot snapshot = table.statistics();
+#ifdef LOOKUP_TABLE_STATISTICS
+	mismatch += !snapshot.enabled || snapshot.lookups != 1103 || snapshot.scalar_lookups != 1100 || snapshot.searches != 1103;
+	mismatch += snapshot.estimated_ns() != snapshot.mean_latency_ns() * 1100; // the batch inputs are not timed
+	mismatch += snapshot.above != 100 || snapshot.below != 2 || snapshot.interpolations != 1001 || snapshot.extrapolations[1] != 102;
+	// the ramp walks over the whole axis, then the batch walks back to 0, up to 8 and up to 50
+	mismatch += snapshot.walks != 1103 || snapshot.walk_distance != 101 + 101 + 8 + 42 || snapshot.samples != (1100 + LookupStatistics::sample_period_ - 1) / LookupStatistics::sample_period_;
+	mismatch += snapshot.fallbacks != 0;
+	table.ResetStatistics();
+	mismatch += table.statistics().lookups != 0;
+
+	// The adaptive search falls back to binary search while the input jumps
+	table.SetSearchMethod(LookupTable::SearchMethod::adaptive);
+	for (int i = 0; i != 200; ++i)
+	{
+		table.Lookup(i % 2 == 0 ? 5.0 : 9800.0);
+	}
+	LookupStatisticsSnapshot adaptive = table.statistics();
+	mismatch += adaptive.fallbacks == 0 || adaptive.walks + adaptive.fallbacks != adaptive.searches; // a fallback is no walk
+
+	// Every table type counts its scalar and cursor lookups
+	MultiLookupTable1D multi(x_axis, Eigen::MatrixXd::Random(3, 101));
+	Eigen::VectorXd multi_results(3);
+	LookupTable::LookupCursor multi_cursor;
+	for (int i = 0; i != 10; ++i)
+	{
+		multi.Lookup(97.0 * i);
+		multi.Lookup(97.0 * i, multi_results, multi_cursor);
+	}
+	mismatch += multi.statistics().lookups != 20 || multi.statistics().scalar_lookups != 20 || multi.statistics().searches != 20;
+#else
+	mismatch += snapshot.enabled || snapshot.lookups != 0 || snapshot.searches != 0;
+#endif
+	std::ostringstream csv;
+	LookupStatisticsSnapshot::WriteCsvHeader(csv);
+	table.statistics().WriteCsv(csv, "ramp");
+	const std::string text = csv.str();
+	mismatch += std::count(text.begin(), text.end(), '\n') != 2;
+	std::cout << "lookup statistics, enabled: " << snapshot.enabled << ", mismatch: " << mismatch << std::endl;
+}
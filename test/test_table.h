@@ -2,9 +2,52 @@
 
 #include <iostream>
 #include <algorithm>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 #include <Eigen/Dense>
 #include "lookup_table1d.h"
 #include "lookup_table2d.h"
+#include "lookup_tablend.h"
+#include "prelookup.h"
+#include "fixed_lookup_table.h"
+#include "compact_lookup_table.h"
+#include "calibration_file.h"
+#include "table_registry.h"
+#include "table_reducer.h"
+#include "lookup_stream.h"
+#include "multi_lookup_table1d.h"
+#include "parallel_lookup.h"
+#include "table_set.h"
+#include "calibration_tables.h" // generated from test/data by table_codegen
 
 void TestTable1D();
-void TestTable2D();
\ No newline at end of file
+void TestTable2D();
+void TestTable1DBatch();
+void TestTable2DBatch();
+void TestTableSharedCursor();
+void TestTableUniformAxis();
+void TestFixedTable();
+void TestTableND();
+void TestPrelookup();
+void TestTableSpline();
+void TestCompactTable();
+void TestCalibrationFile();
+void TestTableRegistry();
+void TestAdaptiveSearch();
+void TestAxisIndex();
+void TestSegmentCoefficients();
+void TestTableReducer();
+void TestInverseLookup();
+void TestLookupGradient();
+void TestSortedLookup();
+void TestMultiTable();
+void TestParallelLookup();
+void TestTableOwnership();
+void TestTableSet();
+void TestGeneratedTables();
+void TestLookupStatistics();
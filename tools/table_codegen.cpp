@@ -0,0 +1,408 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "calibration_file.h"
+#include "lookup_table1d.h"
+#include "lookup_table2d.h"
+
+// Build-time generator of constexpr FixedLookupTable1D / FixedLookupTable2D definitions.
+//   table_codegen --output <header> [--namespace <name>] <input>...
+// Inputs ending in .csv hold one table each, any other input is read as a CalibrationFile with all of its tables.
+// CSV layout, cells separated by commas. '#' lines are comments, their key=value words are settings (name, interp,
+// extrap, lower, upper):
+//   1D   one breakpoint per line: x,y
+//   2D   first line: empty cell then the column breakpoints, following lines: row breakpoint then the map row
+// Every table is validated with the rules of LookupTable1D / LookupTable2D, an invalid table stops the generator
+// with a non-zero exit code so the build fails. The header also static_asserts the validity of every table.
+namespace
+{
+    struct TableData
+    {
+        std::string name;
+        std::string source;
+        std::size_t dimensions = 1;
+        std::vector<double> row_axis;
+        std::vector<double> col_axis;
+        std::vector<double> data; // 1D values, or the 2D map row by row
+        LookupTable::InterpMethod interp_method = LookupTable::InterpMethod::linear;
+        LookupTable::ExtrapMethod extrap_method = LookupTable::ExtrapMethod::clip;
+        bool lower_given = false; // specified extrapolation values, the end values when not given
+        bool upper_given = false;
+        double lower_value = 0;
+        double upper_value = 0;
+    };
+
+    const std::map<std::string, LookupTable::InterpMethod> interp_names{
+        {"nearest", LookupTable::InterpMethod::nearest}, {"linear", LookupTable::InterpMethod::linear}, {"next", LookupTable::InterpMethod::next},
+        {"previous", LookupTable::InterpMethod::previous}, {"cubic", LookupTable::InterpMethod::cubic}, {"pchip", LookupTable::InterpMethod::pchip},
+        {"akima", LookupTable::InterpMethod::akima}};
+    const std::map<std::string, LookupTable::ExtrapMethod> extrap_names{
+        {"clip", LookupTable::ExtrapMethod::clip}, {"linear", LookupTable::ExtrapMethod::linear}, {"specify", LookupTable::ExtrapMethod::specify}};
+
+    bool Fail(const std::string &message)
+    {
+        std::cerr << "table_codegen: " << message << std::endl;
+        return false;
+    }
+
+    std::string Trim(const std::string &text)
+    {
+        const std::size_t begin = text.find_first_not_of(" \t\r");
+        const std::size_t end = text.find_last_not_of(" \t\r");
+        return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+    }
+
+    bool ParseNumber(const std::string &cell, double &value)
+    {
+        char *end = nullptr;
+        value = std::strtod(cell.c_str(), &end);
+        return !cell.empty() && end == cell.c_str() + cell.size();
+    }
+
+    // File name without directory and extension
+    std::string Stem(const std::string &path)
+    {
+        const std::size_t slash = path.find_last_of("/\\");
+        std::string file = slash == std::string::npos ? path : path.substr(slash + 1);
+        const std::size_t dot = file.find_last_of('.');
+        return dot == std::string::npos ? file : file.substr(0, dot);
+    }
+
+    // Table names become C++ identifiers
+    std::string Identifier(const std::string &name)
+    {
+        std::string identifier;
+        for (const char &c : name)
+        {
+            identifier += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+        return (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier[0]))) ? "table_" + identifier : identifier;
+    }
+
+    bool ParseSetting(const std::string &key, const std::string &value, TableData &table)
+    {
+        double number = 0;
+        if (key == "name")
+        {
+            table.name = value;
+        }
+        else if (key == "interp" && interp_names.count(value) != 0)
+        {
+            table.interp_method = interp_names.at(value);
+        }
+        else if (key == "extrap" && extrap_names.count(value) != 0)
+        {
+            table.extrap_method = extrap_names.at(value);
+        }
+        else if ((key == "lower" || key == "upper") && ParseNumber(value, number))
+        {
+            (key == "lower" ? table.lower_value : table.upper_value) = number;
+            (key == "lower" ? table.lower_given : table.upper_given) = true;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadCsv(const std::string &path, std::vector<TableData> &tables)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            return Fail(path + ": cannot be opened");
+        }
+        TableData table;
+        table.name = Stem(path);
+        table.source = path;
+        std::vector<std::vector<std::string>> rows;
+        std::string line;
+        for (std::size_t number = 1; std::getline(file, line); ++number)
+        {
+            line = Trim(line);
+            if (line.empty())
+            {
+                continue;
+            }
+            else if (line[0] == '#')
+            {
+                std::istringstream settings(line.substr(1));
+                std::string setting;
+                while (settings >> setting)
+                {
+                    const std::size_t equal = setting.find('=');
+                    if (equal != std::string::npos && !ParseSetting(setting.substr(0, equal), setting.substr(equal + 1), table))
+                    {
+                        return Fail(path + ":" + std::to_string(number) + ": unknown setting " + setting);
+                    }
+                }
+                continue;
+            }
+            std::vector<std::string> cells;
+            std::istringstream stream(line);
+            std::string cell;
+            while (std::getline(stream, cell, ','))
+            {
+                cells.push_back(Trim(cell));
+            }
+            if (line.back() == ',')
+            {
+                cells.emplace_back();
+            }
+            // Numbers are checked here so the error can point at the line, the first cell of a 2D file is empty
+            for (std::size_t index = 0; index != cells.size(); ++index)
+            {
+                double value = 0;
+                if (!(rows.empty() && index == 0 && cells[index].empty()) && !ParseNumber(cells[index], value))
+                {
+                    return Fail(path + ":" + std::to_string(number) + ": '" + cells[index] + "' is not a number");
+                }
+            }
+            rows.push_back(cells);
+        }
+        if (rows.empty())
+        {
+            return Fail(path + ": no table data");
+        }
+
+        table.dimensions = rows[0][0].empty() ? 2 : 1;
+        for (std::size_t row = 0; row != rows.size(); ++row)
+        {
+            const std::size_t expected = table.dimensions == 1 ? 2 : rows[0].size();
+            if (rows[row].size() != expected)
+            {
+                return Fail(path + ": data line " + std::to_string(row + 1) + " has " + std::to_string(rows[row].size()) + " cells, " + std::to_string(expected) + " expected");
+            }
+            for (std::size_t col = 0; col != rows[row].size(); ++col)
+            {
+                if (row == 0 && col == 0 && table.dimensions == 2)
+                {
+                    continue;
+                }
+                const double value = std::strtod(rows[row][col].c_str(), nullptr);
+                if (table.dimensions == 1)
+                {
+                    (col == 0 ? table.row_axis : table.data).push_back(value);
+                }
+                else
+                {
+                    (row == 0 ? table.col_axis : col == 0 ? table.row_axis : table.data).push_back(value);
+                }
+            }
+        }
+        tables.push_back(table);
+        return true;
+    }
+
+    bool ReadCalibrationFile(const std::string &path, std::vector<TableData> &tables)
+    {
+        CalibrationFile file(path);
+        if (!file.valid())
+        {
+            return Fail(path + ": not a valid calibration file");
+        }
+        for (const auto &name : file.Names())
+        {
+            TableData table;
+            table.name = name;
+            table.source = path;
+            LookupTable1DView view_1d = file.Table1D(name);
+            LookupTable2DView view_2d = file.Table2D(name);
+            if (view_1d.valid())
+            {
+                table.row_axis.assign(view_1d.x_axis().data(), view_1d.x_axis().data() + view_1d.size());
+                table.data.assign(view_1d.y_table().data(), view_1d.y_table().data() + view_1d.size());
+                table.interp_method = view_1d.interp_method();
+                table.extrap_method = view_1d.extrap_method();
+                table.lower_given = true;
+                table.upper_given = true;
+                table.lower_value = view_1d.lower_extrap_value();
+                table.upper_value = view_1d.upper_extrap_value();
+            }
+            else if (view_2d.valid())
+            {
+                table.dimensions = 2;
+                table.row_axis.assign(view_2d.row_axis().data(), view_2d.row_axis().data() + view_2d.rows());
+                table.col_axis.assign(view_2d.col_axis().data(), view_2d.col_axis().data() + view_2d.cols());
+                for (std::size_t row = 0; row != view_2d.rows(); ++row)
+                {
+                    for (std::size_t col = 0; col != view_2d.cols(); ++col)
+                    {
+                        table.data.push_back(view_2d.map_matrix()(row, col));
+                    }
+                }
+                table.interp_method = view_2d.interp_method();
+            }
+            else
+            {
+                return Fail(path + ": table " + name + " cannot be read");
+            }
+            tables.push_back(table);
+        }
+        return true;
+    }
+
+    // Same checks as AssignTableData, plus the methods FixedLookupTable supports
+    bool Validate(const TableData &table)
+    {
+        const std::string where = table.source + ": table " + table.name + ": ";
+        LookupTable::TableState state = LookupTable::TableState::empty;
+        if (table.dimensions == 1)
+        {
+            state = LookupTable1D().CheckTableState(Eigen::Map<const Eigen::RowVectorXd>(table.row_axis.data(), table.row_axis.size()), Eigen::Map<const Eigen::RowVectorXd>(table.data.data(), table.data.size()));
+            if (table.interp_method == LookupTable::InterpMethod::cubic || table.interp_method == LookupTable::InterpMethod::pchip || table.interp_method == LookupTable::InterpMethod::akima)
+            {
+                return Fail(where + "spline interpolation is not available for fixed tables");
+            }
+        }
+        else
+        {
+            const Eigen::Index rows = static_cast<Eigen::Index>(table.row_axis.size());
+            const Eigen::Index cols = static_cast<Eigen::Index>(table.col_axis.size());
+            state = table.data.size() != table.row_axis.size() * table.col_axis.size()
+                        ? LookupTable::TableState::size_not_match
+                        : LookupTable2D().CheckTableState(Eigen::Map<const Eigen::RowVectorXd>(table.row_axis.data(), rows), Eigen::Map<const Eigen::RowVectorXd>(table.col_axis.data(), cols), rows, cols);
+            if (table.interp_method != LookupTable::InterpMethod::linear)
+            {
+                return Fail(where + "2D fixed tables only support linear interpolation");
+            }
+        }
+        switch (state)
+        {
+        case LookupTable::TableState::valid:
+            return true;
+        case LookupTable::TableState::empty:
+            return Fail(where + "empty table");
+        case LookupTable::TableState::size_invalid:
+            return Fail(where + "size out of the range [2 1M]");
+        case LookupTable::TableState::size_not_match:
+            return Fail(where + "values do not match the axis sizes");
+        case LookupTable::TableState::axis_not_increase:
+            return Fail(where + "breakpoints are not strictly increasing");
+        default:
+            return Fail(where + "invalid table");
+        }
+    }
+
+    // Exact decimal form, non-finite values through numeric_limits
+    std::string Literal(const double &value)
+    {
+        if (std::isnan(value))
+        {
+            return "std::numeric_limits<double>::quiet_NaN()";
+        }
+        else if (std::isinf(value))
+        {
+            return value > 0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+        }
+        std::ostringstream stream;
+        stream.precision(std::numeric_limits<double>::max_digits10);
+        stream << value;
+        return stream.str();
+    }
+
+    std::string ArrayLiteral(const std::vector<double> &values)
+    {
+        std::string text = "{{";
+        for (std::size_t index = 0; index != values.size(); ++index)
+        {
+            text += (index == 0 ? "" : index % 8 == 0 ? ",\n      " : ", ") + Literal(values[index]);
+        }
+        return text + "}}";
+    }
+
+    void WriteTable(std::ostream &output, const TableData &table, const std::string &identifier)
+    {
+        const std::string interp = "LookupTable::InterpMethod::" + std::find_if(interp_names.begin(), interp_names.end(), [&](const std::pair<const std::string, LookupTable::InterpMethod> &entry)
+                                                                                { return entry.second == table.interp_method; })->first;
+        const std::string extrap = "LookupTable::ExtrapMethod::" + std::find_if(extrap_names.begin(), extrap_names.end(), [&](const std::pair<const std::string, LookupTable::ExtrapMethod> &entry)
+                                                                                { return entry.second == table.extrap_method; })->first;
+        output << "// " << table.name << " from " << table.source.substr(table.source.find_last_of("/\\") + 1) << "\n";
+        if (table.dimensions == 1)
+        {
+            output << "constexpr FixedLookupTable1D<" << table.row_axis.size() << ", " << interp << ", " << extrap << "> " << identifier << "(\n    "
+                   << ArrayLiteral(table.row_axis) << ",\n    " << ArrayLiteral(table.data);
+            output << ",\n    " << Literal(table.lower_given ? table.lower_value : table.data.front()) << ", " << Literal(table.upper_given ? table.upper_value : table.data.back()) << ");\n";
+        }
+        else
+        {
+            output << "constexpr FixedLookupTable2D<" << table.row_axis.size() << ", " << table.col_axis.size() << "> " << identifier << "(\n    "
+                   << ArrayLiteral(table.row_axis) << ",\n    " << ArrayLiteral(table.col_axis) << ",\n    " << ArrayLiteral(table.data) << ");\n";
+        }
+        output << "static_assert(" << identifier << ".valid(), \"" << table.name << " is not a valid table\");\n\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string output_path;
+    std::string name_space = "calibration";
+    std::vector<std::string> inputs;
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string argument = argv[index];
+        if ((argument == "--output" || argument == "--namespace") && index + 1 < argc)
+        {
+            (argument == "--output" ? output_path : name_space) = argv[++index];
+        }
+        else
+        {
+            inputs.push_back(argument);
+        }
+    }
+    if (output_path.empty() || inputs.empty())
+    {
+        std::cerr << "usage: table_codegen --output <header> [--namespace <name>] <table.csv | calibration file>..." << std::endl;
+        return 2;
+    }
+
+    std::vector<TableData> tables;
+    for (const auto &input : inputs)
+    {
+        const bool csv = input.size() > 4 && input.compare(input.size() - 4, 4, ".csv") == 0;
+        if (!(csv ? ReadCsv(input, tables) : ReadCalibrationFile(input, tables)))
+        {
+            return 1;
+        }
+    }
+    std::map<std::string, std::string> identifiers; // identifier to table name, names must stay distinct
+    for (const auto &table : tables)
+    {
+        if (!Validate(table))
+        {
+            return 1;
+        }
+        const std::string identifier = Identifier(table.name);
+        if (!identifiers.emplace(identifier, table.name).second)
+        {
+            Fail(table.source + ": table " + table.name + " clashes with " + identifiers[identifier] + " as " + identifier);
+            return 1;
+        }
+    }
+
+    // Written to a string first, a failed run leaves no partial header behind
+    std::ostringstream header;
+    header << "#pragma once\n// Generated by table_codegen, do not edit.\n#include <limits>\n#include \"fixed_lookup_table.h\"\n\nnamespace " << name_space << "\n{\n";
+    for (const auto &table : tables)
+    {
+        WriteTable(header, table, Identifier(table.name));
+    }
+    header << "} // namespace " << name_space << "\n";
+    std::ofstream output(output_path, std::ios::trunc);
+    output << header.str();
+    if (!output)
+    {
+        Fail(output_path + ": cannot be written");
+        return 1;
+    }
+    return 0;
+}